@@ -0,0 +1,243 @@
+#include "../headers/bench.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+using namespace bench;
+
+namespace
+{
+
+struct Benchmark
+{
+	std::string name;
+	BenchFunc func;
+	bool sized;
+};
+
+auto registry() -> std::vector<Benchmark> &
+{
+	static std::vector<Benchmark> benchmarks;
+	return benchmarks;
+}
+
+enum class Format
+{
+	TABLE,
+	CSV,
+	JSON
+};
+
+// Writes one result per line. CSV and JSON are meant for scripts that
+// compare runs, columns without a value are 0.
+class Reporter
+{
+public:
+	Reporter(std::ostream &out, Format format) :
+		r_out(out),
+		r_format(format),
+		r_results(0)
+	{
+		if(r_format == Format::CSV)
+			r_out << "name,size,iterations,ns_per_op,items_per_s,bytes_per_item\n";
+		else if(r_format == Format::JSON)
+			r_out << "[\n";
+	}
+
+	~Reporter()
+	{
+		if(r_format == Format::JSON)
+			r_out << (r_results != 0 ? "\n" : "") << "]\n";
+
+		r_out.flush();
+	}
+
+	void report(const std::string &name, std::size_t size, const BenchState &state)
+	{
+		r_out << std::fixed;
+
+		if(r_format == Format::CSV)
+		{
+			r_out << name << "," << size << "," << state.iterations()
+				<< "," << std::setprecision(2) << state.nsPerOp()
+				<< "," << std::setprecision(0) << state.itemsPerSecond()
+				<< "," << std::setprecision(1) << state.bytesPerItem() << "\n";
+		}
+		else if(r_format == Format::JSON)
+		{
+			r_out << (r_results != 0 ? ",\n" : "")
+				<< "  {\"name\": \"" << name << "\", \"size\": " << size << ", \"iterations\": " << state.iterations()
+				<< ", \"ns_per_op\": " << std::setprecision(2) << state.nsPerOp()
+				<< ", \"items_per_s\": " << std::setprecision(0) << state.itemsPerSecond()
+				<< ", \"bytes_per_item\": " << std::setprecision(1) << state.bytesPerItem() << "}";
+		}
+		else
+		{
+			r_out << std::left << std::setw(32) << name
+				<< std::right << std::setw(10) << size
+				<< std::setw(14) << std::setprecision(2) << state.nsPerOp() << " ns/op";
+
+			if(state.itemsPerSecond() > 0.0)
+				r_out << std::setw(14) << std::setprecision(0) << state.itemsPerSecond() << " items/s";
+
+			if(state.bytesPerItem() > 0.0)
+				r_out << std::setw(12) << std::setprecision(1) << state.bytesPerItem() << " B/item";
+
+			r_out << std::endl;
+		}
+
+		r_results++;
+	}
+
+private:
+	std::ostream &r_out;
+	Format r_format;
+	std::size_t r_results;
+};
+
+auto startsWith(const std::string &str, const char *prefix) -> bool
+{
+	return str.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+}
+
+BenchState::BenchState(std::size_t size, std::size_t max_iterations) noexcept :
+	bs_size(size),
+	bs_max_iterations(max_iterations),
+	bs_iterations(0),
+	bs_ns_per_op(0.0),
+	bs_items_per_op(0),
+	bs_bytes_per_item(0.0),
+	bs_escape(nullptr)
+{
+}
+
+auto BenchState::size() const noexcept -> std::size_t
+{
+	return bs_size;
+}
+
+auto BenchState::iterations() const noexcept -> std::size_t
+{
+	return bs_iterations;
+}
+
+auto BenchState::nsPerOp() const noexcept -> double
+{
+	return bs_ns_per_op;
+}
+
+void BenchState::setItemsPerOp(std::size_t items) noexcept
+{
+	bs_items_per_op = items;
+}
+
+auto BenchState::itemsPerSecond() const noexcept -> double
+{
+	return (bs_ns_per_op > 0.0) ? bs_items_per_op * 1e9 / bs_ns_per_op : 0.0;
+}
+
+void BenchState::setBytesPerItem(double bytes) noexcept
+{
+	bs_bytes_per_item = bytes;
+}
+
+auto BenchState::bytesPerItem() const noexcept -> double
+{
+	return bs_bytes_per_item;
+}
+
+BenchRegistrar::BenchRegistrar(const char *name, BenchFunc func, bool sized)
+{
+	registry().push_back(Benchmark{ name, std::move(func), sized });
+}
+
+auto bench::registrySizes() -> const std::vector<std::size_t> &
+{
+	static const std::vector<std::size_t> sizes = { 10, 100, 1000, 10000, 100000 };
+	return sizes;
+}
+
+void bench::fillParser(hyronx::tyr::ArgumentParser &parser, std::size_t size, bool long_args)
+{
+	auto builder = parser.build(size);
+	for(std::size_t i = 0; i < size; i++)
+	{
+		auto num = std::to_string(i);
+		builder.add("", long_args ? "--long" + num : "", "cmd" + num, "Benchmark command " + num, "",
+			hyronx::tyr::ArgumentFlags::OPTIONAL | hyronx::tyr::ArgumentFlags::USER_DATA_ALLOWED, [](hyronx::tyr::StringRef) {});
+	}
+}
+
+// tyr_bench [--format=table|csv|json] [--output=file] [--max-size=n] [filter]
+int main(int argc, char **argv)
+{
+	std::string filter;
+	std::string output;
+	Format format = Format::TABLE;
+	std::size_t max_size = registrySizes().back();
+
+	for(int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if(arg == "--format=csv")
+			format = Format::CSV;
+		else if(arg == "--format=json")
+			format = Format::JSON;
+		else if(arg == "--format=table")
+			format = Format::TABLE;
+		else if(startsWith(arg, "--output="))
+			output = arg.substr(9);
+		else if(startsWith(arg, "--max-size="))
+			max_size = std::stoul(arg.substr(11));
+		else if(startsWith(arg, "--"))
+		{
+			std::cerr << "Unknown option " << arg << std::endl;
+			return 1;
+		}
+		else
+			filter = arg;
+	}
+
+	std::ofstream file;
+	if(!output.empty())
+	{
+		file.open(output);
+		if(!file)
+		{
+			std::cerr << "Could not open " << output << std::endl;
+			return 1;
+		}
+	}
+
+	Reporter reporter(output.empty() ? std::cout : file, format);
+
+	for(auto &benchmark : registry())
+	{
+		if(!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+			continue;
+
+		if(!benchmark.sized)
+		{
+			BenchState state(0, 1 << 24);
+			benchmark.func(state);
+			reporter.report(benchmark.name, 0, state);
+			continue;
+		}
+
+		for(auto size : registrySizes())
+		{
+			if(size > max_size)
+				break;
+
+			BenchState state(size, 1 << 24);
+			benchmark.func(state);
+			reporter.report(benchmark.name, size, state);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,107 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <functional>
+#include <sstream>
+#include <string>
+
+using namespace hyronx;
+
+namespace
+{
+
+// Longer than the small string buffer, like most paths
+const std::string user_data = "/home/user/projects/tyr/build/output.txt";
+
+struct Target
+{
+	std::size_t total = 0;
+
+	void onString(std::string data)
+	{
+		total += data.size();
+	}
+
+	void onRef(tyr::StringRef data)
+	{
+		total += data.size();
+	}
+};
+
+}
+
+// What every call cost before: the user data copied out of the line and a
+// std::function around std::bind copying it once more into the method
+TYR_BENCH_UNSIZED(call_function_bind)
+{
+	Target target;
+	std::function<void(std::string)> func = std::bind(&Target::onString, &target, std::placeholders::_1);
+	std::string data;
+
+	state.measure([&](std::size_t)
+	{
+		data.assign(user_data.data(), user_data.size());
+		func(data);
+		state.keep(target.total);
+	});
+}
+
+// The method is part of the callback's type and inlines into it
+TYR_BENCH_UNSIZED(call_callback_bind)
+{
+	Target target;
+	auto func = tyr::ArgumentFunc::bind<Target, &Target::onRef>(target);
+
+	state.measure([&](std::size_t)
+	{
+		func(user_data);
+		state.keep(target.total);
+	});
+}
+
+// Member pointer stored in the callback, as add(..., &Class::method, this) does
+TYR_BENCH_UNSIZED(call_callback_member)
+{
+	Target target;
+	tyr::ArgumentFunc func(&target, &Target::onRef);
+
+	state.measure([&](std::size_t)
+	{
+		func(user_data);
+		state.keep(target.total);
+	});
+}
+
+// Functions still taking a std::string pay for their copy only
+TYR_BENCH_UNSIZED(call_callback_string)
+{
+	Target target;
+	tyr::ArgumentFunc func(&target, &Target::onString);
+
+	state.measure([&](std::size_t)
+	{
+		func(user_data);
+		state.keep(target.total);
+	});
+}
+
+// A whole command line through dispatch, with the user data passed as a view
+TYR_BENCH_UNSIZED(dispatch_member)
+{
+	Target target;
+	tyr::ArgumentParser parser("bench");
+	parser.add("", "", "open", "Opens a file", "", tyr::ArgumentFlags::USER_DATA_REQUIRED, tyr::ArgumentFunc::bind<Target, &Target::onRef>(target));
+
+	const std::size_t lines = 1000;
+	std::string script;
+	for(std::size_t i = 0; i < lines; i++)
+		script += "open " + user_data + "\n";
+
+	state.setItemsPerOp(lines);
+
+	state.measure([&](std::size_t)
+	{
+		std::istringstream input(script);
+		state.keep(parser.run(input, false));
+	});
+}
@@ -0,0 +1,71 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <string>
+#include <vector>
+
+using namespace hyronx;
+
+// Tab on 'cmd', which every command matches
+TYR_BENCH(complete_all)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size(), true);
+
+	tyr::LineEditor::Completion completion;
+	state.measure([&](std::size_t)
+	{
+		parser.complete("cmd", completion);
+		state.keep(completion.total);
+	});
+}
+
+// Tab on the full number but the last digit
+TYR_BENCH(complete_narrow)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size(), true);
+
+	std::vector<std::string> prefixes;
+	for(std::size_t i = 0; i < state.size(); i += (state.size() / 64) + 1)
+	{
+		auto spelling = "cmd" + std::to_string(i);
+		prefixes.push_back(spelling.substr(0, spelling.size() - 1));
+	}
+
+	tyr::LineEditor::Completion completion;
+	state.measure([&](std::size_t i)
+	{
+		parser.complete(prefixes[i % prefixes.size()], completion);
+		state.keep(completion.total);
+	});
+}
+
+
+// Unknown commands with one swapped pair of letters, e.g. 'mcd42'
+TYR_BENCH(suggest_typo)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size(), true);
+
+	std::vector<std::string> typos;
+	for(std::size_t i = 0; i < state.size(); i += (state.size() / 64) + 1)
+		typos.push_back("mcd" + std::to_string(i));
+
+	state.measure([&](std::size_t i)
+	{
+		state.keep(parser.suggest(typos[i % typos.size()]));
+	});
+}
+
+// Nothing is close, so the whole two-edit search runs
+TYR_BENCH(suggest_miss)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size(), true);
+
+	state.measure([&](std::size_t)
+	{
+		state.keep(parser.suggest("xyzzyx"));
+	});
+}
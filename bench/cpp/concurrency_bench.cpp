@@ -0,0 +1,111 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace hyronx;
+
+namespace
+{
+
+const std::size_t lines = 1000;
+
+auto makeScript(std::size_t size) -> std::string
+{
+	std::string script;
+	for(std::size_t i = 0; i < lines; i++)
+		script += "cmd" + std::to_string((i * 7919) % size) + " data\n";
+
+	return script;
+}
+
+void dispatchLines(bench::BenchState &state, tyr::ArgumentParser &parser, const std::string &script)
+{
+	state.setItemsPerOp(lines);
+
+	state.measure([&](std::size_t)
+	{
+		std::istringstream input(script);
+		state.keep(parser.run(input, false));
+	});
+}
+
+}
+
+// What a line costs without concurrent mode
+TYR_BENCH(dispatch_plain)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size());
+
+	dispatchLines(state, parser, makeScript(state.size()));
+}
+
+// Each line pins a snapshot instead
+TYR_BENCH(dispatch_concurrent)
+{
+	tyr::ArgumentParser parser("bench");
+	parser.setConcurrent(true);
+	bench::fillParser(parser, state.size());
+
+	dispatchLines(state, parser, makeScript(state.size()));
+}
+
+// Another thread adds and removes a command every millisecond, which never
+// blocks the lines
+TYR_BENCH(dispatch_concurrent_writer)
+{
+	tyr::ArgumentParser parser("bench");
+	parser.setConcurrent(true);
+	bench::fillParser(parser, state.size());
+
+	std::atomic<bool> stop(false);
+	std::thread writer([&]()
+	{
+		while(!stop)
+		{
+			parser.remove(parser.add("", "", "plugin", "Added by a plugin", "", tyr::ArgumentFlags::OPTIONAL, nullptr));
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	});
+
+	dispatchLines(state, parser, makeScript(state.size()));
+
+	stop = true;
+	writer.join();
+}
+
+// A change copies the registry once, however many arguments it touches
+TYR_BENCH(publish_change)
+{
+	tyr::ArgumentParser parser("bench");
+	parser.setConcurrent(true);
+	bench::fillParser(parser, state.size());
+
+	state.measure([&](std::size_t)
+	{
+		parser.update([&](tyr::ArgumentParser &changed)
+		{
+			changed.remove(changed.add("", "", "plugin", "Added by a plugin", "", tyr::ArgumentFlags::OPTIONAL, nullptr));
+		});
+	});
+}
+
+// A batch of a builder is published once, not after every add()
+TYR_BENCH(build_concurrent)
+{
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		parser.setConcurrent(true);
+
+		bench::fillParser(parser, state.size());
+		state.keep(parser);
+	});
+}
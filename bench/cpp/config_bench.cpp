@@ -0,0 +1,69 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace hyronx;
+
+namespace
+{
+
+const char config_path[] = "tyr_bench.conf";
+const std::size_t lines = 1000;
+
+void writeConfig(std::size_t size)
+{
+	std::ofstream file(config_path, std::ios::binary | std::ios::trunc);
+	file << "# Benchmark config\n";
+	for(std::size_t i = 0; i < size; i++)
+		file << "key" << i << " = value" << i << "\n";
+	file << "connect = example.org\n";
+}
+
+}
+
+// Commands without user data take it from a config of 'size' entries. The
+// file is only looked at once per line, it is not read again.
+TYR_BENCH(config_dispatch)
+{
+	writeConfig(state.size());
+
+	std::size_t connects = 0;
+	tyr::ArgumentParser parser("bench");
+	parser.add("", "", "connect", "Connects", "", tyr::ArgumentFlags::OPTIONAL | tyr::ArgumentFlags::USER_DATA_REQUIRED, [&](tyr::StringRef) { connects++; });
+	parser.getConfig().setFile(config_path);
+
+	std::string script;
+	for(std::size_t i = 0; i < lines; i++)
+		script += "connect\n";
+
+	state.setItemsPerOp(lines);
+	state.measure([&](std::size_t)
+	{
+		std::istringstream input(script);
+		state.keep(parser.run(input, false));
+	});
+
+	state.keep(connects);
+	std::remove(config_path);
+}
+
+// What an edit of the file costs the next line
+TYR_BENCH(config_reload)
+{
+	writeConfig(state.size());
+
+	tyr::ConfigLayers config;
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		config.setFile(config_path);
+		state.keep(config.table()->size());
+	});
+
+	std::remove(config_path);
+}
@@ -0,0 +1,65 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <string>
+#include <vector>
+
+using namespace hyronx;
+
+namespace
+{
+
+auto makeArgs(std::size_t size) -> tyr::ArgumentStore
+{
+	tyr::ArgumentStore args;
+	for(std::size_t i = 0; i < size; i++)
+	{
+		auto num = std::to_string(i);
+		tyr::Argument arg;
+		arg.long_arg = "--long" + num;
+		arg.command = "cmd" + num;
+		arg.description = "Benchmark command " + num;
+		arg.example = "bench cmd" + num;
+		arg.flags = tyr::ArgumentFlags::LONG_ARG | tyr::ArgumentFlags::COMMAND | ((i % 2 == 0) ? tyr::ArgumentFlags::OPTIONAL : 0);
+		args.add(arg);
+	}
+
+	return args;
+}
+
+}
+
+// Every help call after a registry change
+TYR_BENCH(help_render_cold)
+{
+	auto args = makeArgs(state.size());
+	tyr::ArgumentHelp help;
+
+	state.measure([&](std::size_t)
+	{
+		help.invalidate();
+		state.keep(help.render(args, "bench")->size());
+	});
+}
+
+TYR_BENCH(help_render_cached)
+{
+	auto args = makeArgs(state.size());
+	tyr::ArgumentHelp help;
+
+	state.measure([&](std::size_t)
+	{
+		state.keep(help.render(args, "bench")->size());
+	});
+}
+
+TYR_BENCH(help_page_filtered)
+{
+	auto args = makeArgs(state.size());
+	tyr::ArgumentHelp help;
+
+	state.measure([&](std::size_t)
+	{
+		state.keep(help.renderPage(args, "cmd1", 0, 50));
+	});
+}
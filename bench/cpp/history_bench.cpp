@@ -0,0 +1,92 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <cstdio>
+#include <string>
+
+using namespace hyronx;
+
+namespace
+{
+
+const char history_path[] = "tyr_bench.history";
+
+// A history holding 'size' lines, each line has a number of its own
+void fillHistory(tyr::CommandHistory &history, std::size_t size)
+{
+	history.clear();
+	for(std::size_t i = 0; i < size; i++)
+		history.append("cmd" + std::to_string(i % 100) + " input" + std::to_string(i) + ".txt");
+}
+
+}
+
+// Only the header is read, the cost stays the same for any number of lines
+TYR_BENCH(history_open)
+{
+	std::remove(history_path);
+	{
+		tyr::CommandHistory history(history_path);
+		fillHistory(history, state.size());
+	}
+
+	state.measure([&](std::size_t)
+	{
+		tyr::CommandHistory history(history_path);
+		state.keep(history.size());
+	});
+
+	std::remove(history_path);
+}
+
+TYR_BENCH(history_append)
+{
+	std::remove(history_path);
+	tyr::CommandHistory history(history_path);
+	const std::string line = "cmd42 input.txt";
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		for(std::size_t i = 0; i < state.size(); i++)
+			history.append(line);
+		state.keep(history.next());
+	});
+
+	std::remove(history_path);
+}
+
+// Searches for the oldest line, the pair masks skip most of the others
+TYR_BENCH(history_search)
+{
+	std::remove(history_path);
+	tyr::CommandHistory history(history_path);
+	fillHistory(history, state.size());
+	const std::string text = "input0.txt";
+
+	state.measure([&](std::size_t)
+	{
+		state.keep(history.searchBackward(text));
+	});
+
+	std::remove(history_path);
+}
+
+TYR_BENCH(replay)
+{
+	std::remove(history_path);
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, 100);
+
+	parser.setHistoryFile(history_path);
+	fillHistory(*parser.getHistory(), state.size());
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		auto &history = *parser.getHistory();
+		state.keep(parser.replay(history, history.first(), history.next(), false));
+	});
+
+	std::remove(history_path);
+}
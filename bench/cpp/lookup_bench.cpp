@@ -0,0 +1,62 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <string>
+#include <vector>
+
+using namespace hyronx;
+
+TYR_BENCH(getArgument_hit)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size(), true);
+
+	std::vector<std::string> spellings;
+	for(std::size_t i = 0; i < state.size(); i += (state.size() / 64) + 1)
+		spellings.push_back("cmd" + std::to_string(i));
+
+	state.measure([&](std::size_t i)
+	{
+		state.keep(parser.getArgument(spellings[i % spellings.size()]));
+	});
+}
+
+TYR_BENCH(getArgument_last)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size(), true);
+
+	// Worst case for a linear scan
+	const std::string last = "--long" + std::to_string(state.size() - 1);
+
+	state.measure([&](std::size_t)
+	{
+		state.keep(parser.getArgument(last));
+	});
+}
+
+// Results of a parse with 64 arguments, looked up by their command
+TYR_BENCH(getUserData_hit)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size(), true);
+
+	std::vector<std::string> storage = { "bench" };
+	std::vector<std::string> spellings;
+	for(std::size_t i = 0; i < state.size() && spellings.size() < 64; i += (state.size() / 64) + 1)
+	{
+		spellings.push_back("cmd" + std::to_string(i));
+		storage.push_back(spellings.back());
+	}
+
+	std::vector<char *> argv;
+	for(auto &arg : storage)
+		argv.push_back(&arg[0]);
+
+	parser.parse(static_cast<int>(argv.size()), argv.data(), false);
+
+	state.measure([&](std::size_t i)
+	{
+		state.keep(parser.getUserData(spellings[i % spellings.size()]));
+	});
+}
@@ -0,0 +1,118 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using namespace hyronx;
+
+namespace
+{
+
+// Bytes currently allocated on the heap, 0 where the C library cannot tell
+auto heapBytes() -> std::size_t
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	auto info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+#else
+	return 0;
+#endif
+}
+
+// Texts of a typical command, long enough to not fit into a short string
+auto makeArgument(std::size_t i) -> tyr::Argument
+{
+	auto num = std::to_string(i);
+
+	tyr::Argument arg;
+	arg.long_arg = "--option" + num;
+	arg.command = "option" + num;
+	arg.data_info = "file";
+	arg.description = "Opens the given file and prints option " + num;
+	arg.example = "bench option" + num + " file.txt";
+	arg.flags = tyr::ArgumentFlags::LONG_ARG | tyr::ArgumentFlags::COMMAND | tyr::ArgumentFlags::OPTIONAL | tyr::ArgumentFlags::USER_DATA_ALLOWED;
+	arg.func = [](std::string) {};
+
+	return arg;
+}
+
+template<typename Build>
+void reportBytes(bench::BenchState &state, Build &&build)
+{
+	auto before = heapBytes();
+	auto registry = build();
+	auto after = heapBytes();
+
+	if(after > before)
+		state.setBytesPerItem(static_cast<double>(after - before) / state.size());
+}
+
+auto buildVector(std::size_t size) -> std::vector<tyr::Argument>
+{
+	std::vector<tyr::Argument> args;
+	for(std::size_t i = 0; i < size; i++)
+		args.push_back(makeArgument(i));
+
+	return args;
+}
+
+auto buildStore(std::size_t size) -> tyr::ArgumentStore
+{
+	tyr::ArgumentStore args;
+	for(std::size_t i = 0; i < size; i++)
+		args.add(makeArgument(i));
+
+	return args;
+}
+
+}
+
+// How the parser stored its registry before: one Argument with seven strings each
+TYR_BENCH(memory_vector_layout)
+{
+	reportBytes(state, [&] { return buildVector(state.size()); });
+
+	state.measure([&](std::size_t)
+	{
+		state.keep(buildVector(state.size()));
+	});
+}
+
+TYR_BENCH(memory_store_layout)
+{
+	reportBytes(state, [&] { return buildStore(state.size()); });
+
+	state.measure([&](std::size_t)
+	{
+		state.keep(buildStore(state.size()));
+	});
+}
+
+// Store, index and help cache of a whole parser
+TYR_BENCH(memory_parser)
+{
+	auto build = [&]
+	{
+		std::unique_ptr<tyr::ArgumentParser> parser(new tyr::ArgumentParser("bench"));
+		for(std::size_t i = 0; i < state.size(); i++)
+		{
+			auto arg = makeArgument(i);
+			parser->add(arg);
+		}
+
+		return parser;
+	};
+
+	reportBytes(state, build);
+
+	state.measure([&](std::size_t)
+	{
+		state.keep(build());
+	});
+}
@@ -0,0 +1,84 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <string>
+#include <vector>
+
+using namespace hyronx;
+
+namespace
+{
+
+// The registry of bench::fillParser() and the short options of SyntheticArgv
+void fillOptions(tyr::ArgumentParser &parser, std::size_t size)
+{
+	bench::fillParser(parser, size, true);
+
+	parser.add("-a", "", "", "Flag a", "", tyr::ArgumentFlags::OPTIONAL, [](std::string) {});
+	parser.add("-b", "", "", "Flag b", "", tyr::ArgumentFlags::OPTIONAL, [](std::string) {});
+	parser.add("-o", "--output", "", "Output file", "", tyr::ArgumentFlags::OPTIONAL | tyr::ArgumentFlags::USER_DATA_REQUIRED, [](std::string) {});
+}
+
+// Options in the styles wrappers pass them: --name=value, --name value, -abo value, -ovalue.
+// Every group of four tokens is one of each.
+class SyntheticArgv
+{
+public:
+	SyntheticArgv(std::size_t registry_size, std::size_t groups = 75)
+	{
+		storage.push_back("bench");
+		for(std::size_t i = 0; i < groups; i++)
+		{
+			auto num = std::to_string(i % registry_size);
+			storage.push_back("--long" + num + "=value" + num);
+			storage.push_back("-abofile" + num);
+			storage.push_back("--long" + num);
+			storage.push_back("plain" + num);
+		}
+
+		for(auto &arg : storage)
+			argv.push_back(&arg[0]);
+	}
+
+	auto argc() -> int
+	{
+		return static_cast<int>(argv.size());
+	}
+
+	auto data() -> char **
+	{
+		return argv.data();
+	}
+
+private:
+	std::vector<std::string> storage;
+	std::vector<char *> argv;
+};
+
+}
+
+TYR_BENCH(parse_argv)
+{
+	tyr::ArgumentParser parser("bench");
+	fillOptions(parser, state.size());
+	SyntheticArgv argv(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		parser.parse(argv.argc(), argv.data(), false);
+	});
+}
+
+// The registry stays at 100 arguments, the size is the number of argv tokens
+TYR_BENCH(parse_argv_length)
+{
+	tyr::ArgumentParser parser("bench");
+	fillOptions(parser, 100);
+	SyntheticArgv argv(100, state.size() / 4 + 1);
+	state.setItemsPerOp(argv.argc() - 1);
+
+	state.measure([&](std::size_t)
+	{
+		parser.parse(argv.argc(), argv.data(), false);
+	});
+}
@@ -0,0 +1,135 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hyronx;
+
+namespace
+{
+
+const std::size_t lines_per_size = 100;
+
+auto makeLine(std::size_t i) -> std::string
+{
+	return "record " + std::to_string(i) + " of the benchmark input";
+}
+
+}
+
+// Lines through one channel between two threads
+TYR_BENCH(channel_lines)
+{
+	const std::size_t lines = state.size() * lines_per_size;
+	const std::string text = makeLine(0);
+	state.setItemsPerOp(lines);
+
+	state.measure([&](std::size_t)
+	{
+		tyr::CommandChannel channel;
+		std::thread writer([&]()
+		{
+			for(std::size_t i = 0; i < lines; i++)
+				channel.write(text);
+
+			channel.closeWrite();
+		});
+
+		std::string line;
+		std::size_t count = 0;
+		while(channel.read(line))
+			count++;
+
+		writer.join();
+		state.keep(count);
+	});
+}
+
+// 'produce | consume', both commands run at once and the lines never pile up
+TYR_BENCH(pipe_streaming)
+{
+	const std::size_t lines = state.size() * lines_per_size;
+	std::size_t bytes = 0;
+	state.setItemsPerOp(lines);
+
+	tyr::ArgumentParser parser("bench");
+	parser.addStream("", "", "produce", "Writes lines", "", tyr::ArgumentFlags::OPTIONAL, [&](tyr::CommandStream &stream)
+	{
+		for(std::size_t i = 0; i < lines && stream.write(makeLine(i)); i++)
+		{
+		}
+	});
+	parser.addStream("", "", "consume", "Reads lines", "", tyr::ArgumentFlags::OPTIONAL, [&](tyr::CommandStream &stream)
+	{
+		std::string line;
+		while(stream.read(line))
+			bytes += line.size();
+	});
+
+	std::string line = "produce | consume";
+	state.measure([&](std::size_t)
+	{
+		parser.tryDispatch(line).value();
+		state.keep(bytes);
+	});
+}
+
+// The same lines handed over the way it had to be done without pipes, all
+// of them kept until the second command runs
+TYR_BENCH(pipe_materialized)
+{
+	const std::size_t lines = state.size() * lines_per_size;
+	std::vector<std::string> results;
+	std::size_t bytes = 0;
+	state.setItemsPerOp(lines);
+
+	tyr::ArgumentParser parser("bench");
+	parser.add("", "", "produce", "Collects lines", "", tyr::ArgumentFlags::OPTIONAL, [&](tyr::StringRef)
+	{
+		results.clear();
+		for(std::size_t i = 0; i < lines; i++)
+			results.push_back(makeLine(i));
+	});
+	parser.add("", "", "consume", "Reads the collected lines", "", tyr::ArgumentFlags::OPTIONAL, [&](tyr::StringRef)
+	{
+		for(auto &result : results)
+			bytes += result.size();
+
+		// Only freed once everything was consumed
+		std::vector<std::string>().swap(results);
+	});
+
+	std::string line = "produce && consume";
+	state.measure([&](std::size_t)
+	{
+		parser.tryDispatch(line).value();
+		state.keep(bytes);
+	});
+}
+
+// A consumer that stops after the first lines stops the producer too
+TYR_BENCH(pipe_early_exit)
+{
+	tyr::ArgumentParser parser("bench");
+	parser.addStream("", "", "produce", "Writes lines without end", "", tyr::ArgumentFlags::OPTIONAL, [&](tyr::CommandStream &stream)
+	{
+		for(std::size_t i = 0; stream.write(makeLine(i)); i++)
+		{
+		}
+	});
+	parser.addStream("", "", "first", "Reads 10 lines", "", tyr::ArgumentFlags::OPTIONAL, [&](tyr::CommandStream &stream)
+	{
+		std::string line;
+		for(int i = 0; i < 10 && stream.read(line); i++)
+		{
+		}
+	});
+
+	std::string line = "produce | first";
+	state.measure([&](std::size_t)
+	{
+		parser.tryDispatch(line).value();
+	});
+}
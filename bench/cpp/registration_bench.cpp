@@ -0,0 +1,244 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace hyronx;
+
+namespace
+{
+
+struct Texts
+{
+	std::string long_arg;
+	std::string command;
+	std::string description;
+	std::string example;
+};
+
+// Built once so the benchmarks only time the registration itself
+auto makeTexts(std::size_t size) -> std::vector<Texts>
+{
+	std::vector<Texts> texts;
+	for(std::size_t i = 0; i < size; i++)
+	{
+		auto num = std::to_string(i);
+		texts.push_back(Texts{ "--long" + num, "cmd" + num, "Benchmark command " + num, "bench cmd" + num });
+	}
+
+	return texts;
+}
+
+}
+
+// Reported items/s are registered arguments per second
+TYR_BENCH(add_single)
+{
+	auto texts = makeTexts(state.size());
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		for(auto &text : texts)
+			parser.add("", text.long_arg, text.command, text.description, text.example, tyr::ArgumentFlags::OPTIONAL, [](std::string) {});
+
+		state.keep(parser);
+	});
+}
+
+TYR_BENCH(add_vector)
+{
+	auto texts = makeTexts(state.size());
+	state.setItemsPerOp(state.size());
+
+	std::vector<tyr::Argument> args(texts.size());
+	for(std::size_t i = 0; i < texts.size(); i++)
+	{
+		args[i].long_arg = texts[i].long_arg;
+		args[i].command = texts[i].command;
+		args[i].description = texts[i].description;
+		args[i].example = texts[i].example;
+		args[i].flags = tyr::ArgumentFlags::OPTIONAL;
+		args[i].func = [](std::string) {};
+	}
+
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		parser.add(args);
+
+		state.keep(parser);
+	});
+}
+
+// An Argument filled per call and moved in, so its callable is not copied
+TYR_BENCH(add_moved)
+{
+	auto texts = makeTexts(state.size());
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		for(auto &text : texts)
+		{
+			tyr::Argument arg;
+			arg.long_arg = text.long_arg;
+			arg.command = text.command;
+			arg.description = text.description;
+			arg.example = text.example;
+			arg.flags = tyr::ArgumentFlags::OPTIONAL;
+			arg.func = [](std::string) {};
+			parser.add(std::move(arg));
+		}
+
+		state.keep(parser);
+	});
+}
+
+TYR_BENCH(add_builder)
+{
+	auto texts = makeTexts(state.size());
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		auto builder = parser.build(texts.size());
+		for(auto &text : texts)
+			builder.add("", text.long_arg, text.command, text.description, text.example, tyr::ArgumentFlags::OPTIONAL, [](std::string) {});
+
+		state.keep(parser);
+	});
+}
+
+// Many small add(vector) calls, each of them only looks at its own arguments
+TYR_BENCH(add_vector_batches)
+{
+	const std::size_t batch_size = 100;
+	auto texts = makeTexts(state.size());
+	state.setItemsPerOp(state.size());
+
+	std::vector<std::vector<tyr::Argument>> batches;
+	for(std::size_t first = 0; first < texts.size(); first += batch_size)
+	{
+		batches.emplace_back();
+		for(std::size_t i = first; i < std::min(first + batch_size, texts.size()); i++)
+		{
+			tyr::Argument arg;
+			arg.long_arg = texts[i].long_arg;
+			arg.command = texts[i].command;
+			arg.description = texts[i].description;
+			arg.flags = tyr::ArgumentFlags::OPTIONAL;
+			arg.func = [](std::string) {};
+			batches.back().push_back(arg);
+		}
+	}
+
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		for(auto &batch : batches)
+			parser.add(batch);
+
+		state.keep(parser);
+	});
+}
+
+// Registers and then removes every argument by its handle
+TYR_BENCH(remove_handle)
+{
+	auto texts = makeTexts(state.size());
+	state.setItemsPerOp(state.size());
+
+	std::vector<tyr::ArgumentHandle> handles(texts.size());
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		for(std::size_t i = 0; i < texts.size(); i++)
+			handles[i] = parser.add("", texts[i].long_arg, texts[i].command, texts[i].description, texts[i].example, tyr::ArgumentFlags::OPTIONAL, [](std::string) {});
+
+		for(auto handle : handles)
+			parser.remove(handle);
+
+		state.keep(parser);
+	});
+}
+
+// One argument added to and removed from a full registry per call, the
+// tombstones are compacted away every so often
+TYR_BENCH(add_remove_churn)
+{
+	auto texts = makeTexts(state.size());
+
+	tyr::ArgumentParser parser("bench");
+	for(auto &text : texts)
+		parser.add("", text.long_arg, text.command, text.description, text.example, tyr::ArgumentFlags::OPTIONAL, [](std::string) {});
+
+	state.measure([&](std::size_t i)
+	{
+		auto handle = parser.add("", "--churn", "churn", "Churned command", "", tyr::ArgumentFlags::OPTIONAL, [](std::string) {});
+		parser.remove(handle);
+
+		state.keep(i);
+	});
+}
+
+namespace
+{
+
+// The commands split into groups of 50 as a tool with command groups would
+void addGroups(tyr::ArgumentParser &parser, const std::vector<Texts> &texts, bool eager)
+{
+	const std::size_t group_size = 50;
+	for(std::size_t first = 0; first < texts.size(); first += group_size)
+	{
+		auto name = "group" + std::to_string(first / group_size);
+		parser.addGroup(name, "Benchmark group", [&texts, first](tyr::ArgumentParser &group)
+		{
+			const std::size_t last = std::min(first + group_size, texts.size());
+			group.reserve(last - first);
+			for(std::size_t i = first; i < last; i++)
+				group.add("", texts[i].long_arg, texts[i].command, texts[i].description, texts[i].example, tyr::ArgumentFlags::OPTIONAL, [](std::string) {});
+		});
+
+		if(eager)
+			parser.getGroup(name);
+	}
+}
+
+}
+
+// Startup with every group registered right away
+TYR_BENCH(add_groups_eager)
+{
+	auto texts = makeTexts(state.size());
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		addGroups(parser, texts, true);
+
+		state.keep(parser);
+	});
+}
+
+// Startup with the groups left to their first use
+TYR_BENCH(add_groups_lazy)
+{
+	auto texts = makeTexts(state.size());
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		addGroups(parser, texts, false);
+
+		state.keep(parser);
+	});
+}
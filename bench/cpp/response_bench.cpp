@@ -0,0 +1,94 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace hyronx;
+
+namespace
+{
+
+const char response_path[] = "tyr_bench.rsp";
+const std::size_t million = 1000000;
+
+// One path per line like a build system writes them, every fourth quoted
+void writeResponseFile(std::size_t size, bool quoted)
+{
+	std::ofstream file(response_path, std::ios::binary | std::ios::trunc);
+	for(std::size_t i = 0; i < size; i++)
+	{
+		if(quoted && i % 4 == 0)
+			file << "\"src/module " << i % 100 << "/file" << i << ".cpp\"\n";
+		else
+			file << "src/module" << i % 100 << "/file" << i << ".cpp\n";
+	}
+}
+
+void addOptions(tyr::ArgumentParser &parser)
+{
+	parser.add("-o", "--output", "", "Output file", "", tyr::ArgumentFlags::OPTIONAL | tyr::ArgumentFlags::USER_DATA_REQUIRED, [](tyr::StringRef) {});
+	parser.add("-v", "--verbose", "", "Verbose", "", tyr::ArgumentFlags::OPTIONAL, [](tyr::StringRef) {});
+}
+
+void parseResponseFile(bench::BenchState &state, std::size_t size, bool quoted)
+{
+	writeResponseFile(size, quoted);
+
+	tyr::ArgumentParser parser("bench");
+	addOptions(parser);
+
+	char arg0[] = "bench", arg1[] = "-o", arg2[] = "out.bin", arg3[] = "@tyr_bench.rsp";
+	char *argv[] = { arg0, arg1, arg2, arg3 };
+	state.setItemsPerOp(size);
+
+	state.measure([&](std::size_t)
+	{
+		parser.parse(4, argv);
+		state.keep(parser.getPositional().size());
+	});
+
+	std::remove(response_path);
+}
+
+}
+
+// The same paths passed in argv, what a response file is measured against
+TYR_BENCH(parse_argv_paths)
+{
+	std::vector<std::string> storage = { "bench", "-o", "out.bin" };
+	for(std::size_t i = 0; i < state.size(); i++)
+		storage.push_back("src/module" + std::to_string(i % 100) + "/file" + std::to_string(i) + ".cpp");
+
+	std::vector<char *> argv;
+	for(auto &arg : storage)
+		argv.push_back(&arg[0]);
+
+	tyr::ArgumentParser parser("bench");
+	addOptions(parser);
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		parser.parse(static_cast<int>(argv.size()), argv.data());
+		state.keep(parser.getPositional().size());
+	});
+}
+
+TYR_BENCH(parse_response_file)
+{
+	parseResponseFile(state, state.size(), false);
+}
+
+// Unquoting copies only the pages it writes to
+TYR_BENCH(parse_response_file_quoted)
+{
+	parseResponseFile(state, state.size(), true);
+}
+
+TYR_BENCH_UNSIZED(parse_response_file_million)
+{
+	parseResponseFile(state, million, false);
+}
@@ -0,0 +1,94 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <string>
+
+using namespace hyronx;
+
+namespace
+{
+
+// Close to no command, so the error message has no suggestions
+const std::string missing = "zzzzzzzz";
+
+}
+
+// What a mistyped command cost before, the error unwinds to the catch
+TYR_BENCH(getArgument_miss_throwing)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size());
+
+	state.measure([&](std::size_t)
+	{
+		try
+		{
+			state.keep(parser.getArgument(missing));
+		}
+		catch(const tyr::ArgumentException &e)
+		{
+			state.keep(e.code());
+		}
+	});
+}
+
+TYR_BENCH(getArgument_miss_try)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size());
+
+	state.measure([&](std::size_t)
+	{
+		auto result = parser.tryGetArgument(missing);
+		state.keep(result.code());
+	});
+}
+
+TYR_BENCH(getArgument_hit_try)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size());
+
+	const std::string last = "cmd" + std::to_string(state.size() - 1);
+
+	state.measure([&](std::size_t)
+	{
+		auto result = parser.tryGetArgument(last);
+		state.keep(result.ok());
+	});
+}
+
+// A loop line with an unknown command, thrown like run() used to
+TYR_BENCH(dispatch_miss_throwing)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size());
+
+	std::string line = "cmd0 data && " + missing + " data";
+
+	state.measure([&](std::size_t)
+	{
+		try
+		{
+			parser.tryDispatch(line).value();
+		}
+		catch(const tyr::ArgumentException &e)
+		{
+			state.keep(e.code());
+		}
+	});
+}
+
+TYR_BENCH(dispatch_miss_try)
+{
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, state.size());
+
+	std::string line = "cmd0 data && " + missing + " data";
+
+	state.measure([&](std::size_t)
+	{
+		auto result = parser.tryDispatch(line);
+		state.keep(result.code());
+	});
+}
@@ -0,0 +1,90 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <sstream>
+#include <string>
+
+using namespace hyronx;
+
+namespace
+{
+
+const std::size_t script_lines = 100000;
+
+auto makeScript() -> std::string
+{
+	std::string script;
+	for(std::size_t i = 0; i < script_lines; i++)
+	{
+		auto num = std::to_string(i % 1000);
+		script += (i % 2 == 0) ? "open file" + num + ".txt && save\n" : "--open \"my file " + num + "\"\n";
+	}
+
+	return script;
+}
+
+// Command lines as a user would type them against a registry of the given
+// size: single commands, commands with user data and && chains
+void runRecorded(bench::BenchState &state, bool with_stats)
+{
+	tyr::ArgumentParser parser("bench");
+	parser.setStatsEnabled(with_stats);
+	bench::fillParser(parser, state.size(), true);
+
+	const std::size_t lines = 1000;
+	std::string recorded;
+	for(std::size_t i = 0; i < lines; i++)
+	{
+		auto num = std::to_string((i * 7919) % state.size());
+		switch(i % 3)
+		{
+		case 0:
+			recorded += "cmd" + num + "\n";
+			break;
+		case 1:
+			recorded += "--long" + num + " \"some data " + num + "\"\n";
+			break;
+		default:
+			recorded += "cmd" + num + " data && cmd0 && --long" + num + "\n";
+			break;
+		}
+	}
+
+	state.setItemsPerOp(lines);
+
+	state.measure([&](std::size_t)
+	{
+		std::istringstream input(recorded);
+		state.keep(parser.run(input, false));
+	});
+}
+
+}
+
+// Reported items/s are command lines per second
+TYR_BENCH_UNSIZED(run_script)
+{
+	tyr::ArgumentParser parser("bench");
+	parser.add("-o", "--open", "open", "Opens a file", "", tyr::ArgumentFlags::USER_DATA_REQUIRED, [](std::string) {});
+	parser.add("-s", "--save", "save", "Saves the current file", "", 0, [](std::string) {});
+
+	const std::string script = makeScript();
+	state.setItemsPerOp(script_lines);
+
+	state.measure([&](std::size_t)
+	{
+		std::istringstream input(script);
+		state.keep(parser.run(input, false));
+	});
+}
+
+TYR_BENCH(run_recorded)
+{
+	runRecorded(state, false);
+}
+
+// Same lines with every call timed
+TYR_BENCH(run_recorded_stats)
+{
+	runRecorded(state, true);
+}
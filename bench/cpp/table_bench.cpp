@@ -0,0 +1,52 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+using namespace hyronx;
+
+namespace
+{
+
+void noop(const char *)
+{
+}
+
+constexpr tyr::StaticArgument table_args[] = {
+	{ "-h", "--help", "help", "command", "Shows information for registered commands", "bench help", tyr::ArgumentFlags::OPTIONAL | tyr::ArgumentFlags::USER_DATA_ALLOWED, &noop },
+	{ "-o", "--open", "open", "file", "Opens a file", "bench -o file1", tyr::ArgumentFlags::OPTIONAL | tyr::ArgumentFlags::USER_DATA_REQUIRED, &noop },
+	{ "-s", "--save", "save", "", "Saves the current file", "bench save", tyr::ArgumentFlags::OPTIONAL, &noop },
+	{ "-v", "--verbose", "", "", "Prints more output", "", tyr::ArgumentFlags::OPTIONAL, &noop }
+};
+
+constexpr auto table = tyr::makeArgumentTable(table_args);
+
+char arg0[] = "bench";
+char arg1[] = "-v";
+char arg2[] = "--open";
+char arg3[] = "file1";
+char arg4[] = "save";
+char *bench_argv[] = { arg0, arg1, arg2, arg3, arg4 };
+
+}
+
+// Startup of a short-lived program: construct the registry and parse argv
+TYR_BENCH_UNSIZED(startup_parser)
+{
+	state.measure([&](std::size_t)
+	{
+		tyr::ArgumentParser parser("bench");
+		parser.add("-o", "--open", "open", "Opens a file", "bench -o file1", tyr::ArgumentFlags::USER_DATA_REQUIRED, [](std::string) {});
+		parser.add("-s", "--save", "save", "Saves the current file", "bench save", 0, [](std::string) {});
+		parser.add("-v", "--verbose", "", "Prints more output", "", 0, [](std::string) {});
+		parser.parse(5, bench_argv);
+		state.keep(parser);
+	});
+}
+
+TYR_BENCH_UNSIZED(startup_table)
+{
+	state.measure([&](std::size_t)
+	{
+		auto result = table.parse(5, bench_argv);
+		state.keep(result);
+	});
+}
@@ -0,0 +1,53 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+#include "../../tyr/headers/arg_tokenizer.hpp"
+
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace hyronx;
+
+namespace
+{
+
+// A long command line of 200 commands chained with &&
+auto longLine() -> std::string
+{
+	std::string line;
+	for(int i = 0; i < 100; i++)
+		line += "open file" + std::to_string(i) + ".txt && save --verbose && ";
+
+	return line + "exit";
+}
+
+}
+
+// The former parseAndRun() splitting
+TYR_BENCH_UNSIZED(tokenize_stringstream)
+{
+	const std::string line = longLine();
+
+	state.measure([&](std::size_t)
+	{
+		std::vector<std::string> commands;
+		std::stringstream cmdline_stream(line);
+		std::copy(std::istream_iterator<std::string>(cmdline_stream), std::istream_iterator<std::string>(), std::back_inserter(commands));
+		state.keep(commands);
+	});
+}
+
+TYR_BENCH_UNSIZED(tokenize_tokenizer)
+{
+	const std::string line = longLine();
+	std::string buffer;
+	tyr::CommandTokenizer tokenizer;
+
+	state.measure([&](std::size_t)
+	{
+		// The tokenizer works in place, so start from a fresh copy like the loop does
+		buffer.assign(line);
+		state.keep(tokenizer.tokenize(buffer));
+	});
+}
@@ -0,0 +1,60 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <string>
+#include <vector>
+
+using namespace hyronx;
+
+namespace
+{
+
+auto makeNumbers(std::size_t size) -> std::vector<std::string>
+{
+	std::vector<std::string> numbers;
+	for(std::size_t i = 0; i < size; i++)
+		numbers.push_back(std::to_string(i * 7919));
+
+	return numbers;
+}
+
+}
+
+// What handlers used to do: copy the user data and call std::stoi
+TYR_BENCH(convert_stoi)
+{
+	auto numbers = makeNumbers(state.size());
+	state.setItemsPerOp(numbers.size());
+
+	state.measure([&](std::size_t)
+	{
+		long long sum = 0;
+		for(auto &number : numbers)
+		{
+			std::string copy = number;
+			sum += std::stoi(copy);
+		}
+
+		state.keep(sum);
+	});
+}
+
+TYR_BENCH(convert_value)
+{
+	auto numbers = makeNumbers(state.size());
+	static const std::vector<std::string> no_choices;
+	state.setItemsPerOp(numbers.size());
+
+	state.measure([&](std::size_t)
+	{
+		long long sum = 0;
+		tyr::ArgumentValue value;
+		for(auto &number : numbers)
+		{
+			tyr::ArgumentValue::convert(tyr::ArgumentValue::INT, number, no_choices, value);
+			sum += value.asInt();
+		}
+
+		state.keep(sum);
+	});
+}
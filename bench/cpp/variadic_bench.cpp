@@ -0,0 +1,57 @@
+#include "../headers/bench.hpp"
+#include "../../tyr/tyr"
+
+#include <sstream>
+#include <string>
+
+using namespace hyronx;
+
+namespace
+{
+
+void runScript(bench::BenchState &state, tyr::ArgumentParser &parser, const std::string &script)
+{
+	state.setItemsPerOp(state.size());
+
+	state.measure([&](std::size_t)
+	{
+		std::istringstream input(script);
+		state.keep(parser.run(input, false));
+	});
+}
+
+}
+
+// 'state.size()' files opened one command at a time
+TYR_BENCH(values_per_command)
+{
+	std::size_t opened = 0;
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, 100);
+	parser.add("", "", "open", "Opens a file", "", tyr::ArgumentFlags::OPTIONAL | tyr::ArgumentFlags::USER_DATA_REQUIRED, [&](tyr::StringRef) { opened++; });
+
+	std::string script;
+	for(std::size_t i = 0; i < state.size(); i++)
+		script += "open file" + std::to_string(i) + ".txt\n";
+
+	runScript(state, parser, script);
+	state.keep(opened);
+}
+
+// The same files as the values of one variadic command
+TYR_BENCH(values_variadic)
+{
+	std::size_t opened = 0;
+	tyr::ArgumentParser parser("bench");
+	bench::fillParser(parser, 100);
+	parser.addVariadic("", "", "open", "Opens files", "", tyr::ArgumentFlags::OPTIONAL, tyr::ArgumentArity::atLeast(1),
+		[&](tyr::ArgumentValues values) { opened += values.size(); });
+
+	std::string script = "open";
+	for(std::size_t i = 0; i < state.size(); i++)
+		script += " file" + std::to_string(i) + ".txt";
+	script += "\n";
+
+	runScript(state, parser, script);
+	state.keep(opened);
+}
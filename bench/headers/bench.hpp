@@ -0,0 +1,106 @@
+#ifndef __TYR_BENCH__
+#define __TYR_BENCH__
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../../tyr/tyr"
+
+namespace bench
+{
+
+class BenchState
+{
+public:
+	BenchState(std::size_t size, std::size_t max_iterations) noexcept;
+
+	auto size() const noexcept -> std::size_t;
+	auto iterations() const noexcept -> std::size_t;
+	auto nsPerOp() const noexcept -> double;
+
+	// For operations that process many items, e.g. command lines
+	void setItemsPerOp(std::size_t items) noexcept;
+	auto itemsPerSecond() const noexcept -> double;
+
+	// For memory reports, e.g. heap bytes per registered argument
+	void setBytesPerItem(double bytes) noexcept;
+	auto bytesPerItem() const noexcept -> double;
+
+	// Times calls of 'func(i)'. Everything outside is setup.
+	template<typename Func>
+	void measure(Func &&func);
+
+	// Keeps the optimizer from discarding a result
+	template<typename Type>
+	void keep(const Type &value) noexcept;
+
+private:
+	std::size_t bs_size;
+	std::size_t bs_max_iterations;
+	std::size_t bs_iterations;
+	double bs_ns_per_op;
+	std::size_t bs_items_per_op;
+	double bs_bytes_per_item;
+	const void * volatile bs_escape;
+};
+
+using BenchFunc = std::function<void(BenchState &)>;
+
+struct BenchRegistrar
+{
+	// Unsized benchmarks do not depend on the registry size and run once
+	BenchRegistrar(const char *name, BenchFunc func, bool sized = true);
+};
+
+// Registry sizes every benchmark is run with
+auto registrySizes() -> const std::vector<std::size_t> &;
+
+// Registers the commands cmd0 to cmd<size - 1>, which take optional user
+// data, with --long0 to --long<size - 1> as long arguments if 'long_args'.
+// A concurrent parser publishes them once.
+void fillParser(hyronx::tyr::ArgumentParser &parser, std::size_t size, bool long_args = false);
+
+template<typename Func>
+void BenchState::measure(Func &&func)
+{
+	// Double the batch until it runs long enough to be measured reliably
+	const std::chrono::milliseconds min_time(50);
+
+	for(std::size_t iterations = 1; ; iterations *= 2)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for(std::size_t i = 0; i < iterations; i++)
+			func(i);
+		auto elapsed = std::chrono::steady_clock::now() - start;
+
+		if(elapsed >= min_time || iterations >= bs_max_iterations)
+		{
+			bs_iterations = iterations;
+			bs_ns_per_op = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+			break;
+		}
+	}
+}
+
+template<typename Type>
+void BenchState::keep(const Type &value) noexcept
+{
+	bs_escape = &value;
+}
+
+}
+
+#define TYR_BENCH(name) \
+	static void name(bench::BenchState &); \
+	static bench::BenchRegistrar name##_registrar(#name, name); \
+	static void name(bench::BenchState &state)
+
+#define TYR_BENCH_UNSIZED(name) \
+	static void name(bench::BenchState &); \
+	static bench::BenchRegistrar name##_registrar(#name, name, false); \
+	static void name(bench::BenchState &state)
+
+#endif // !__TYR_BENCH__
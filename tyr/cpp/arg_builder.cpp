@@ -0,0 +1,67 @@
+#include "../headers/arg_builder.hpp"
+#include "../headers/arg_parser.hpp"
+
+#include <utility>
+
+using namespace CPM_TYR_CN;
+
+ArgumentBuilder::ArgumentBuilder(ArgumentParser &parser, std::size_t count) :
+	ab_parser(&parser),
+	ab_size(0),
+	ab_locked(parser.lockRegistry())
+{
+	try
+	{
+		ab_parser->reserve(count);
+	}
+	catch(...)
+	{
+		if(ab_locked)
+			ab_parser->unlockRegistry();
+
+		throw;
+	}
+}
+
+ArgumentBuilder::ArgumentBuilder(ArgumentBuilder &&orig) noexcept :
+	ab_parser(orig.ab_parser),
+	ab_size(orig.ab_size),
+	ab_locked(orig.ab_locked)
+{
+	orig.ab_locked = false;
+}
+
+ArgumentBuilder::~ArgumentBuilder()
+{
+	if(ab_locked)
+		ab_parser->unlockRegistry();
+}
+
+auto ArgumentBuilder::add(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, ArgumentFunc func) -> ArgumentBuilder &
+{
+	ab_parser->add(s_arg, l_arg, cmd, desc, ex, flags, std::move(func));
+	ab_size++;
+
+	return *this;
+}
+
+auto ArgumentBuilder::add(const Argument &arg) -> ArgumentBuilder &
+{
+	ab_parser->add(arg);
+	ab_size++;
+
+	return *this;
+}
+
+auto ArgumentBuilder::add(Argument &&arg) -> ArgumentBuilder &
+{
+	ab_parser->add(std::move(arg));
+	ab_size++;
+
+	return *this;
+}
+
+auto ArgumentBuilder::size() const noexcept -> std::size_t
+{
+	return ab_size;
+}
@@ -0,0 +1,184 @@
+#include "../headers/arg_channel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace CPM_TYR_CN;
+
+const std::size_t CommandChannel::default_capacity;
+
+namespace
+{
+
+// A sleeping reader is only woken once this part of the ring is filled, so
+// one wake-up moves many lines instead of one
+const std::size_t wake_fraction = 8;
+
+// A reader does not wait longer for a writer that only writes now and then
+const std::chrono::milliseconds reader_timeout(1);
+
+}
+
+CommandChannel::CommandChannel(std::size_t capacity) :
+	chn_ring(std::max<std::size_t>(capacity, 1)),
+	chn_head(0),
+	chn_size(0),
+	chn_write_closed(false),
+	chn_read_closed(false),
+	chn_reader_waiting(false),
+	chn_writer_waiting(false),
+	chn_wake_size(std::max<std::size_t>(chn_ring.size() / wake_fraction, 1)),
+	chn_taken(),
+	chn_taken_pos(0),
+	chn_mutex(),
+	chn_readable(),
+	chn_writable()
+{
+}
+
+auto CommandChannel::write(StringRef line) -> bool
+{
+	const char newline = '\n';
+	StringRef pieces[2] = { line, StringRef(&newline, 1) };
+
+	std::unique_lock<std::mutex> lock(chn_mutex);
+	for(auto piece : pieces)
+	{
+		while(!piece.empty())
+		{
+			while(chn_size == chn_ring.size() && !chn_read_closed)
+			{
+				chn_writer_waiting = true;
+				chn_writable.wait(lock);
+			}
+
+			if(chn_read_closed)
+				return false;
+
+			// As much as fits behind the tail, the rest wraps around
+			auto tail = (chn_head + chn_size) % chn_ring.size();
+			auto count = std::min(piece.size(), std::min(chn_ring.size() - chn_size, chn_ring.size() - tail));
+			std::memcpy(chn_ring.data() + tail, piece.data(), count);
+			chn_size += count;
+			piece = piece.substr(count);
+
+			// Only a reader that sleeps is woken, one that is busy sees the bytes anyway
+			if(chn_reader_waiting && chn_size >= chn_wake_size)
+			{
+				chn_reader_waiting = false;
+				chn_readable.notify_one();
+			}
+		}
+	}
+
+	return true;
+}
+
+auto CommandChannel::read(std::string &line) -> bool
+{
+	line.clear();
+
+	while(true)
+	{
+		// Lines taken out of the ring before need no lock
+		auto first = chn_taken.data() + chn_taken_pos;
+		auto rest = chn_taken.size() - chn_taken_pos;
+		auto newline = static_cast<const char *>(std::memchr(first, '\n', rest));
+		if(newline != nullptr)
+		{
+			line.append(first, newline - first);
+			chn_taken_pos += newline - first + 1;
+			return true;
+		}
+
+		line.append(first, rest);
+		chn_taken.clear();
+		chn_taken_pos = 0;
+
+		// A writer that stopped in the middle of a line still passed on its start
+		if(!take())
+			return !line.empty();
+	}
+}
+
+auto CommandChannel::take() -> bool
+{
+	std::unique_lock<std::mutex> lock(chn_mutex);
+	while(chn_size == 0 && !chn_write_closed)
+	{
+		chn_reader_waiting = true;
+		chn_readable.wait_for(lock, reader_timeout);
+	}
+
+	chn_reader_waiting = false;
+	if(chn_size == 0)
+		return false;
+
+	// Everything at once, in up to two pieces if it wraps
+	auto count = std::min(chn_size, chn_ring.size() - chn_head);
+	chn_taken.append(chn_ring.data() + chn_head, count);
+	chn_taken.append(chn_ring.data(), chn_size - count);
+	chn_head = (chn_head + chn_size) % chn_ring.size();
+	chn_size = 0;
+
+	if(chn_writer_waiting)
+	{
+		chn_writer_waiting = false;
+		chn_writable.notify_one();
+	}
+
+	return true;
+}
+
+void CommandChannel::closeWrite()
+{
+	std::lock_guard<std::mutex> lock(chn_mutex);
+	chn_write_closed = true;
+	chn_readable.notify_one();
+}
+
+void CommandChannel::closeRead()
+{
+	std::lock_guard<std::mutex> lock(chn_mutex);
+	chn_read_closed = true;
+	chn_writable.notify_one();
+}
+
+CommandStream::CommandStream(StringRef user_data, CommandChannel *input, CommandChannel *output) noexcept :
+	stm_user_data(user_data),
+	stm_input(input),
+	stm_output(output)
+{
+}
+
+auto CommandStream::userData() const noexcept -> StringRef
+{
+	return stm_user_data;
+}
+
+auto CommandStream::read(std::string &line) -> bool
+{
+	if(stm_input == nullptr)
+	{
+		line.clear();
+		return false;
+	}
+
+	return stm_input->read(line);
+}
+
+auto CommandStream::write(StringRef line) -> bool
+{
+	if(stm_output != nullptr)
+		return stm_output->write(line);
+
+	std::cout.write(line.data(), line.size()).put('\n');
+	return static_cast<bool>(std::cout);
+}
+
+auto CommandStream::isPiped() const noexcept -> bool
+{
+	return stm_input != nullptr || stm_output != nullptr;
+}
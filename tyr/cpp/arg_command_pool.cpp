@@ -0,0 +1,132 @@
+#include "../headers/arg_command_pool.hpp"
+
+using namespace CPM_TYR_CN;
+
+CommandPool::CommandPool(std::size_t workers) :
+	cp_queues(),
+	cp_workers(),
+	cp_wake_mutex(),
+	cp_wake(),
+	cp_pending(0),
+	cp_next_queue(0),
+	cp_stop(false)
+{
+	if(workers == 0)
+		workers = 1;
+
+	for(std::size_t i = 0; i < workers; i++)
+		cp_queues.emplace_back(new Queue());
+
+	for(std::size_t i = 0; i < workers; i++)
+		cp_workers.emplace_back(&CommandPool::work, this, i);
+}
+
+CommandPool::~CommandPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(cp_wake_mutex);
+		cp_stop = true;
+	}
+	cp_wake.notify_all();
+
+	for(auto &worker : cp_workers)
+		worker.join();
+}
+
+void CommandPool::runGroup(std::size_t count, const std::function<void(std::size_t)> &task)
+{
+	std::atomic<std::size_t> remaining(count);
+	std::mutex done_mutex;
+	std::condition_variable done;
+
+	for(std::size_t i = 0; i < count; i++)
+	{
+		submit([&, i]()
+		{
+			task(i);
+
+			// Under the lock, the waiter may return and take 'done' with it as
+			// soon as it sees the count at 0
+			std::lock_guard<std::mutex> lock(done_mutex);
+			if(--remaining == 0)
+				done.notify_all();
+		});
+	}
+
+	// Help instead of blocking, then wait for the tasks still running
+	while(remaining > 0 && tryRun(0))
+	{
+	}
+
+	std::unique_lock<std::mutex> lock(done_mutex);
+	done.wait(lock, [&]() { return remaining == 0; });
+}
+
+auto CommandPool::size() const noexcept -> std::size_t
+{
+	return cp_workers.size();
+}
+
+void CommandPool::submit(std::function<void()> task)
+{
+	// Count first, so 'cp_pending' never drops below the number of queued tasks
+	{
+		std::lock_guard<std::mutex> lock(cp_wake_mutex);
+		cp_pending++;
+	}
+
+	auto &queue = *cp_queues[cp_next_queue++ % cp_queues.size()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+
+	cp_wake.notify_one();
+}
+
+auto CommandPool::tryRun(std::size_t own_queue) -> bool
+{
+	std::function<void()> task;
+
+	// Newest task from the own queue first, then steal the oldest from the others
+	for(std::size_t i = 0; i < cp_queues.size() && !task; i++)
+	{
+		auto &queue = *cp_queues[(own_queue + i) % cp_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if(queue.tasks.empty())
+			continue;
+
+		if(i == 0)
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+	}
+
+	if(!task)
+		return false;
+
+	cp_pending--;
+	task();
+	return true;
+}
+
+void CommandPool::work(std::size_t own_queue)
+{
+	while(true)
+	{
+		if(tryRun(own_queue))
+			continue;
+
+		std::unique_lock<std::mutex> lock(cp_wake_mutex);
+		cp_wake.wait(lock, [this]() { return cp_stop || cp_pending > 0; });
+
+		if(cp_stop)
+			return;
+	}
+}
@@ -0,0 +1,241 @@
+#include "../headers/arg_config.hpp"
+#include "../headers/arg_exception.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
+using namespace CPM_TYR_CN;
+
+namespace
+{
+
+inline auto isBlank(char c) noexcept -> bool
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+auto trim(const char *first, const char *last) noexcept -> StringRef
+{
+	while(first != last && isBlank(*first))
+		first++;
+
+	while(last != first && isBlank(last[-1]))
+		last--;
+
+	return StringRef(first, last - first);
+}
+
+inline auto lessKey(StringRef left, StringRef right) noexcept -> bool
+{
+	auto result = std::memcmp(left.data(), right.data(), std::min(left.size(), right.size()));
+	return result < 0 || (result == 0 && left.size() < right.size());
+}
+
+}
+
+ConfigTable::ConfigTable() noexcept :
+	ct_text(),
+	ct_entries()
+{
+}
+
+ConfigTable::ConfigTable(std::string text, const std::string &path) :
+	ct_text(std::move(text)),
+	ct_entries()
+{
+	// The entries point into the text, which never changes from here on
+	const char *iter = ct_text.data();
+	const char *end = iter + ct_text.size();
+	std::size_t line_number = 0;
+	while(iter != end)
+	{
+		const char *line_end = std::find(iter, end, '\n');
+		auto line = trim(iter, line_end);
+		iter = (line_end != end) ? line_end + 1 : end;
+		line_number++;
+
+		if(line.empty() || line[0] == '#')
+			continue;
+
+		auto equal_pos = line.find('=');
+		auto key = (equal_pos != std::string::npos) ? trim(line.begin(), line.begin() + equal_pos) : StringRef();
+		if(key.empty())
+			throw ArgumentException(ArgumentException::SYNTAX_ERROR, "The line " + std::to_string(line_number) + " of " + path + " is no 'key = value'");
+
+		auto value = trim(line.begin() + equal_pos + 1, line.end());
+		if(value.size() >= 2 && (value[0] == '"' || value[0] == '\'') && value[value.size() - 1] == value[0])
+			value = value.substr(1, value.size() - 2);
+
+		ct_entries.push_back(Entry{ key, value });
+	}
+
+	// The last entry of a key wins
+	std::stable_sort(ct_entries.begin(), ct_entries.end(), [](const Entry &left, const Entry &right)
+	{
+		return lessKey(left.key, right.key);
+	});
+
+	std::size_t kept = 0;
+	for(std::size_t pos = 0; pos < ct_entries.size(); pos++)
+	{
+		if(kept != 0 && ct_entries[kept - 1].key == ct_entries[pos].key)
+			ct_entries[kept - 1] = ct_entries[pos];
+		else
+			ct_entries[kept++] = ct_entries[pos];
+	}
+
+	ct_entries.resize(kept);
+	ct_entries.shrink_to_fit();
+}
+
+auto ConfigTable::find(StringRef key, StringRef &value) const noexcept -> bool
+{
+	auto iter = std::lower_bound(ct_entries.begin(), ct_entries.end(), key, [](const Entry &entry, StringRef searched)
+	{
+		return lessKey(entry.key, searched);
+	});
+
+	if(iter == ct_entries.end() || iter->key != key)
+		return false;
+
+	value = iter->value;
+	return true;
+}
+
+auto ConfigTable::size() const noexcept -> std::size_t
+{
+	return ct_entries.size();
+}
+
+auto ConfigLayers::FileStamp::operator ==(const FileStamp &other) const noexcept -> bool
+{
+	return exists == other.exists && size == other.size && seconds == other.seconds && nanoseconds == other.nanoseconds && inode == other.inode;
+}
+
+ConfigLayers::ConfigLayers() noexcept :
+	cl_mutex(),
+	cl_path(),
+	cl_env_prefix(),
+	cl_table(std::make_shared<ConfigTable>()),
+	cl_stamp(FileStamp{ false, 0, 0, 0, 0 }),
+	cl_checked(false),
+	cl_loads(0),
+	cl_pool(),
+	cl_defaults()
+{
+}
+
+void ConfigLayers::setFile(std::string path)
+{
+	std::lock_guard<std::mutex> lock(cl_mutex);
+	cl_path = std::move(path);
+	cl_table = std::make_shared<ConfigTable>();
+	cl_checked = false;
+}
+
+void ConfigLayers::setEnvPrefix(std::string prefix)
+{
+	std::lock_guard<std::mutex> lock(cl_mutex);
+	cl_env_prefix = std::move(prefix);
+}
+
+void ConfigLayers::setDefault(StringRef key, StringRef value)
+{
+	std::lock_guard<std::mutex> lock(cl_mutex);
+	auto stored = cl_pool.store(value);
+
+	auto iter = cl_defaults.find(key);
+	if(iter != cl_defaults.end())
+		iter->second = stored;
+	else
+		cl_defaults.emplace(cl_pool.store(key), stored);
+}
+
+auto ConfigLayers::table() -> std::shared_ptr<const ConfigTable>
+{
+	std::lock_guard<std::mutex> lock(cl_mutex);
+	if(cl_path.empty())
+		return cl_table;
+
+	// One stat per call, the file is only read when it changed
+	FileStamp stamp{ false, 0, 0, 0, 0 };
+#if defined(__unix__) || defined(__APPLE__)
+	struct stat info;
+	if(::stat(cl_path.c_str(), &info) == 0)
+	{
+#if defined(__APPLE__)
+		stamp = FileStamp{ true, static_cast<std::uint64_t>(info.st_size), info.st_mtimespec.tv_sec, info.st_mtimespec.tv_nsec, static_cast<std::uint64_t>(info.st_ino) };
+#else
+		stamp = FileStamp{ true, static_cast<std::uint64_t>(info.st_size), info.st_mtim.tv_sec, info.st_mtim.tv_nsec, static_cast<std::uint64_t>(info.st_ino) };
+#endif
+	}
+#else
+	// Without a modification time the file is read once
+	if(cl_checked)
+		return cl_table;
+
+	stamp.exists = static_cast<bool>(std::ifstream(cl_path));
+#endif
+
+	if(cl_checked && stamp == cl_stamp)
+		return cl_table;
+
+	// A broken file is reported once, the values read before stay
+	cl_stamp = stamp;
+	cl_checked = true;
+
+	if(!stamp.exists)
+	{
+		cl_table = std::make_shared<ConfigTable>();
+		return cl_table;
+	}
+
+	std::ifstream file(cl_path, std::ios::binary);
+	std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	cl_table = std::make_shared<ConfigTable>(std::move(text), cl_path);
+	cl_loads++;
+
+	return cl_table;
+}
+
+auto ConfigLayers::find(const ConfigTable &file, StringRef key, StringRef &value) const -> bool
+{
+	std::lock_guard<std::mutex> lock(cl_mutex);
+	if(!cl_env_prefix.empty())
+	{
+		// --dry-run is MYAPP_DRY_RUN
+		std::string name = cl_env_prefix;
+		for(auto c : key)
+			name.push_back((c == '-' || c == '.') ? '_' : static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+
+		if(const char *env_value = std::getenv(name.c_str()))
+		{
+			value = StringRef(env_value);
+			return true;
+		}
+	}
+
+	if(file.find(key, value))
+		return true;
+
+	auto iter = cl_defaults.find(key);
+	if(iter == cl_defaults.end())
+		return false;
+
+	value = iter->second;
+	return true;
+}
+
+auto ConfigLayers::loadCount() const -> std::size_t
+{
+	std::lock_guard<std::mutex> lock(cl_mutex);
+	return cl_loads;
+}
@@ -14,7 +14,7 @@ ArgumentException::ArgumentException(ErrorCode error, std::string info) :
 {
 }
 
-auto ArgumentException::what() const -> const char *
+auto ArgumentException::what() const noexcept -> const char *
 {
 	return ex_info.c_str();
 }
@@ -22,4 +22,29 @@ auto ArgumentException::what() const -> const char *
 auto ArgumentException::code() const -> ErrorCode
 {
 	return ex_code;
+}
+
+namespace
+{
+
+auto joinErrors(const std::vector<ArgumentGroupException::Error> &errors) -> std::string
+{
+	std::string info = std::to_string(errors.size()) + " of the commands failed:";
+	for(auto &error : errors)
+		info += "\n  " + error.first + ": " + error.second.what();
+
+	return info;
+}
+
+}
+
+ArgumentGroupException::ArgumentGroupException(std::vector<Error> errors) :
+	ArgumentException(GROUP_ERROR, joinErrors(errors)),
+	ex_errors(std::move(errors))
+{
+}
+
+auto ArgumentGroupException::errors() const noexcept -> const std::vector<Error> &
+{
+	return ex_errors;
 }
\ No newline at end of file
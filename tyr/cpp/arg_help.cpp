@@ -0,0 +1,242 @@
+#include "../headers/arg_help.hpp"
+
+#include <algorithm>
+
+using namespace CPM_TYR_CN;
+
+namespace
+{
+
+inline auto appendText(std::string &out, StringRef str) -> std::string &
+{
+	return out.append(str.data(), str.size());
+}
+
+// Same as 'out << std::setw(width) << str'
+void appendRight(std::string &out, StringRef str, std::size_t width)
+{
+	if(str.size() < width)
+		out.append(width - str.size(), ' ');
+
+	appendText(out, str);
+}
+
+void appendBool(std::string &out, const char *name, bool value)
+{
+	out += name;
+	out += value ? "true\n" : "false\n";
+}
+
+auto contains(StringRef str, StringRef filter) noexcept -> bool
+{
+	return std::search(str.begin(), str.end(), filter.begin(), filter.end()) != str.end();
+}
+
+void appendInfo(std::string &info, const ArgumentView &arg, bool with_equal)
+{
+	auto flags = arg.flags();
+
+	if(flags.hasShortArg())
+		appendText(info += "      ", arg.shortArg());
+
+	if(flags.hasLongArg())
+	{
+		appendText(info += (flags.hasShortArg() ? ", " : "      "), arg.longArg());
+		if(with_equal && flags.isUserDataAllowed())
+			info += "=";
+	}
+
+	if(flags.hasCommand())
+		appendText(info += (flags.hasLongArg() ? ", " : "      "), arg.command());
+
+	if(!arg.dataInfo().empty())
+		appendText(info += " <", arg.dataInfo()) += "> ";
+
+	if(!arg.description().empty())
+	{
+		appendRight(info, arg.description(), 45);
+		info += "\n";
+	}
+
+	info += "\n";
+}
+
+}
+
+ArgumentHelp::ArgumentHelp() noexcept :
+	ah_mutex(),
+	ah_valid(false),
+	ah_usage(),
+	ah_required(),
+	ah_optional(),
+	ah_examples(),
+	ah_text()
+{
+}
+
+void ArgumentHelp::invalidate() noexcept
+{
+	std::lock_guard<std::mutex> lock(ah_mutex);
+	ah_valid = false;
+	ah_text.reset();
+}
+
+void ArgumentHelp::append(const ArgumentView &arg)
+{
+	std::lock_guard<std::mutex> lock(ah_mutex);
+
+	// Nothing to extend before the first render
+	if(ah_valid)
+	{
+		appendSections(arg);
+		ah_text.reset();
+	}
+}
+
+auto ArgumentHelp::render(const ArgumentStore &args, const std::string &exec_name) -> std::shared_ptr<const std::string>
+{
+	std::lock_guard<std::mutex> lock(ah_mutex);
+	if(!ah_valid)
+	{
+		ah_usage.assign(exec_name).append(" ");
+		ah_required.assign("    Required:\n");
+		ah_optional.assign("    Optional:\n");
+		ah_examples.assign("    Examples:\n");
+
+		for(auto arg : args)
+			appendSections(arg);
+
+		ah_valid = true;
+		ah_text.reset();
+	}
+
+	// Callers still printing the one before keep it
+	if(!ah_text)
+	{
+		std::string text("Help:\n\n");
+		text.reserve(text.size() + ah_usage.size() + 2 + ah_required.size() + ah_optional.size() + ah_examples.size());
+		text.append(ah_usage).append("\n\n");
+		text.append(ah_required);
+		text.append(ah_optional);
+		text.append(ah_examples);
+		ah_text = std::make_shared<const std::string>(std::move(text));
+	}
+
+	return ah_text;
+}
+
+auto ArgumentHelp::renderArgument(const ArgumentView &arg) const -> std::string
+{
+	std::string help("Extended help:\n\n    Arguments/Command:\n");
+
+	auto flags = arg.flags();
+	std::string data_info = !arg.dataInfo().empty() ? ("<" + arg.dataInfo().str() + ">") : "";
+
+	if(flags.hasShortArg())
+		appendText(help.append("      Short argument: "), arg.shortArg()).append(!data_info.empty() ? " " : "").append(data_info).append("\n");
+
+	if(flags.hasLongArg())
+		appendText(help.append("      Long argument: "), arg.longArg()).append(!data_info.empty() ? "=" : "").append(data_info).append("\n");
+
+	if(flags.hasCommand())
+		appendText(help.append("      Command: "), arg.command()).append(!data_info.empty() ? " " : "").append(data_info).append("\n");
+
+	help.append("\n    Full description:\n");
+	if(!arg.longDescription().empty())
+		appendText(help.append("      "), arg.longDescription()).append("\n");
+	else if(!arg.description().empty())
+		appendText(help.append("      "), arg.description()).append("\n");
+
+	help.append("\n    Flags:\n");
+	appendBool(help, "      Has short arg: ", flags.hasShortArg());
+	appendBool(help, "      Has long arg: ", flags.hasLongArg());
+	appendBool(help, "      Has command: ", flags.hasCommand());
+	appendBool(help, "      Is optional: ", flags.isOptional());
+	appendBool(help, "      Is loop only: ", flags.isLoopOnly());
+	appendBool(help, "      Is user data allowed: ", flags.isUserDataAllowed());
+	appendBool(help, "      Is user data required: ", flags.isUserDataRequired());
+	help.append("\n");
+
+	return help;
+}
+
+auto ArgumentHelp::renderPage(const ArgumentStore &args, StringRef filter, std::size_t page, std::size_t page_size) const -> std::string
+{
+	if(page_size == 0)
+		page_size = 1;
+
+	std::string help;
+
+	std::size_t matches = 0;
+	const std::size_t first = page * page_size;
+	for(auto arg : args)
+	{
+		if(!filter.empty() && !contains(arg.shortArg(), filter) && !contains(arg.longArg(), filter)
+			&& !contains(arg.command(), filter) && !contains(arg.description(), filter))
+			continue;
+
+		if(matches >= first && matches < first + page_size)
+		{
+			const char *separator = "      ";
+			for(auto spelling : { arg.shortArg(), arg.longArg(), arg.command() })
+			{
+				if(!spelling.empty())
+				{
+					appendText(help += separator, spelling);
+					separator = ", ";
+				}
+			}
+
+			if(!arg.dataInfo().empty())
+				appendText(help += " <", arg.dataInfo()) += ">";
+
+			if(!arg.description().empty())
+				appendText(help += "    ", arg.description());
+
+			help += "\n";
+		}
+
+		matches++;
+	}
+
+	const std::size_t pages = (matches + page_size - 1) / page_size;
+	std::string header = "Help (page " + std::to_string(std::min(page + 1, std::max<std::size_t>(pages, 1))) + " of " + std::to_string(std::max<std::size_t>(pages, 1))
+		+ ", " + std::to_string(matches) + " matching):\n\n";
+	help.insert(0, header);
+
+	return help;
+}
+
+void ArgumentHelp::appendSections(const ArgumentView &arg)
+{
+	auto flags = arg.flags();
+
+	if(!flags.isLoopOnly())
+	{
+		if(flags.hasShortArg())
+			appendText(ah_usage += "[", arg.shortArg());
+
+		if(flags.hasLongArg())
+		{
+			appendText(ah_usage += (flags.hasShortArg() ? '|' : '['), arg.longArg());
+			if(flags.isUserDataAllowed())
+				ah_usage += "=";
+		}
+
+		if(flags.hasCommand())
+			appendText(ah_usage += (flags.hasLongArg() ? '|' : '['), arg.command());
+
+		if(!arg.dataInfo().empty())
+			appendText(ah_usage += " <", arg.dataInfo()) += ">";
+
+		ah_usage += "] ";
+	}
+
+	if(!flags.isOptional())
+		appendInfo(ah_required, arg, true);
+	else
+		appendInfo(ah_optional, arg, false);
+
+	if(!arg.example().empty())
+		appendText(ah_examples += "      ", arg.example()) += "\n";
+}
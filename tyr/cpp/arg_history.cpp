@@ -0,0 +1,244 @@
+#include "../headers/arg_history.hpp"
+#include "../headers/arg_exception.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace CPM_TYR_CN;
+
+const std::size_t CommandHistory::default_data_size;
+const std::size_t CommandHistory::default_max_entries;
+const std::uint64_t CommandHistory::npos;
+
+// Stored in the byte order of the machine, a history is not meant to move
+// between machines. Positions in the data never wrap, the byte of position
+// p is at p % data_size.
+struct CommandHistory::Header
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t max_entries;
+	std::uint64_t data_size;
+	std::uint64_t first;		// Number of the oldest line
+	std::uint64_t next;			// Number the next line gets
+	std::uint64_t tail;			// Position the next line is written at
+	std::uint64_t reserved[2];
+};
+
+struct CommandHistory::Entry
+{
+	std::uint64_t position;
+	std::uint64_t pairs;		// A bit for every pair of neighbouring characters
+	std::uint32_t length;
+	std::uint32_t reserved;
+};
+
+namespace
+{
+
+const char history_magic[8] = { 'T', 'Y', 'R', 'H', 'I', 'S', 'T', '\0' };
+const std::uint32_t history_version = 1;
+
+auto pairMask(StringRef text) noexcept -> std::uint64_t
+{
+	std::uint64_t mask = 0;
+	for(std::size_t pos = 1; pos < text.size(); pos++)
+		mask |= std::uint64_t(1) << ((static_cast<unsigned char>(text[pos - 1]) * 31u + static_cast<unsigned char>(text[pos])) & 63u);
+
+	return mask;
+}
+
+}
+
+CommandHistory::CommandHistory(const std::string &path, std::size_t data_size, std::size_t max_entries) :
+	ch_path(path),
+	ch_fd(-1),
+	ch_map(nullptr),
+	ch_map_size(0),
+	ch_header(nullptr),
+	ch_entries(nullptr),
+	ch_data(nullptr),
+	ch_data_size(0),
+	ch_max_entries(0)
+{
+#if defined(__unix__) || defined(__APPLE__)
+	ch_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if(ch_fd < 0)
+		throw ArgumentException(ArgumentException::IO_ERROR, "The history " + path + " could not be opened");
+
+	auto fail = [&](const char *what)
+	{
+		::close(ch_fd);
+		return ArgumentException(ArgumentException::IO_ERROR, "The history " + path + " could not be " + what);
+	};
+
+	// Held until the file is closed, a second process would append over the same lines
+	if(::flock(ch_fd, LOCK_EX | LOCK_NB) != 0)
+		throw fail("locked, it is already open");
+
+	// Only the header is read, whatever the number of lines
+	Header header;
+	struct stat info;
+	bool valid = ::fstat(ch_fd, &info) == 0 && ::pread(ch_fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))
+		&& std::memcmp(header.magic, history_magic, sizeof(history_magic)) == 0 && header.version == history_version
+		&& header.max_entries != 0 && header.data_size != 0 && header.first <= header.next && header.next - header.first <= header.max_entries
+		&& static_cast<std::uint64_t>(info.st_size) == sizeof(Header) + header.max_entries * sizeof(Entry) + header.data_size;
+
+	if(!valid)
+	{
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.magic, history_magic, sizeof(history_magic));
+		header.version = history_version;
+		header.max_entries = static_cast<std::uint32_t>(std::min<std::size_t>(std::max<std::size_t>(max_entries, 1), std::numeric_limits<std::uint32_t>::max()));
+		header.data_size = std::max<std::size_t>(data_size, 1);
+	}
+
+	ch_map_size = sizeof(Header) + header.max_entries * sizeof(Entry) + header.data_size;
+
+	// A new file is all zeros, which is an empty index
+	if(!valid && (::ftruncate(ch_fd, 0) != 0 || ::ftruncate(ch_fd, static_cast<off_t>(ch_map_size)) != 0))
+		throw fail("created");
+
+	void *map = ::mmap(nullptr, ch_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, ch_fd, 0);
+	if(map == MAP_FAILED)
+		throw fail("mapped");
+
+	ch_map = static_cast<char *>(map);
+	ch_header = reinterpret_cast<Header *>(ch_map);
+	ch_entries = reinterpret_cast<Entry *>(ch_map + sizeof(Header));
+	ch_data = ch_map + sizeof(Header) + header.max_entries * sizeof(Entry);
+
+	ch_data_size = header.data_size;
+	ch_max_entries = header.max_entries;
+
+	if(!valid)
+		std::memcpy(ch_header, &header, sizeof(header));
+#else
+	(void)data_size;
+	(void)max_entries;
+	throw ArgumentException(ArgumentException::IO_ERROR, "Memory-mapped histories are not supported on this platform");
+#endif
+}
+
+CommandHistory::~CommandHistory()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	::munmap(ch_map, ch_map_size);
+	::close(ch_fd);
+#endif
+}
+
+void CommandHistory::append(StringRef line)
+{
+	auto &header = *ch_header;
+	if(line.empty() || line.size() > ch_data_size || line.size() > std::numeric_limits<std::uint32_t>::max())
+		return;
+
+	// A line never wraps around the end of the data, so it can be handed out directly
+	auto position = header.tail;
+	if(position % ch_data_size + line.size() > ch_data_size)
+		position += ch_data_size - position % ch_data_size;
+
+	// Drop the lines that get overwritten and the one whose index entry is
+	// reused. The header changes first, a crash meanwhile loses them early.
+	while(header.first < header.next && (header.next - header.first >= ch_max_entries || entry(header.first).position + ch_data_size < position + line.size()))
+		header.first++;
+
+	std::memcpy(ch_data + position % ch_data_size, line.data(), line.size());
+	ch_entries[header.next % ch_max_entries] = Entry{ position, pairMask(line), static_cast<std::uint32_t>(line.size()), 0 };
+
+	// The line only counts once it is complete
+	header.tail = position + line.size();
+	header.next++;
+}
+
+void CommandHistory::clear() noexcept
+{
+	// The numbers go on
+	ch_header->first = ch_header->next;
+}
+
+void CommandHistory::sync()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	if(::msync(ch_map, ch_map_size, MS_SYNC) != 0)
+		throw ArgumentException(ArgumentException::IO_ERROR, "The history " + ch_path + " could not be written");
+#endif
+}
+
+auto CommandHistory::first() const noexcept -> std::uint64_t
+{
+	return ch_header->first;
+}
+
+auto CommandHistory::next() const noexcept -> std::uint64_t
+{
+	return ch_header->next;
+}
+
+auto CommandHistory::size() const noexcept -> std::size_t
+{
+	return static_cast<std::size_t>(ch_header->next - ch_header->first);
+}
+
+auto CommandHistory::empty() const noexcept -> bool
+{
+	return ch_header->next == ch_header->first;
+}
+
+auto CommandHistory::at(std::uint64_t number) const -> StringRef
+{
+	if(number < ch_header->first || number >= ch_header->next)
+		throw ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, "The history has no line " + std::to_string(number));
+
+	return text(entry(number));
+}
+
+auto CommandHistory::searchBackward(StringRef text, std::uint64_t before) const noexcept -> std::uint64_t
+{
+	// Lines missing a pair of 'text' cannot contain it, their text is not even touched
+	const auto mask = pairMask(text);
+	for(auto number = std::min(before, ch_header->next); number > ch_header->first; number--)
+	{
+		auto &current = entry(number - 1);
+		if((current.pairs & mask) != mask || current.length < text.size())
+			continue;
+
+		// A damaged line is empty and contains nothing
+		auto line = this->text(current);
+		if(!line.empty() && std::search(line.begin(), line.end(), text.begin(), text.end()) != line.end())
+			return number - 1;
+	}
+
+	return npos;
+}
+
+auto CommandHistory::path() const noexcept -> const std::string &
+{
+	return ch_path;
+}
+
+auto CommandHistory::entry(std::uint64_t number) const noexcept -> const Entry &
+{
+	return ch_entries[number % ch_max_entries];
+}
+
+auto CommandHistory::text(const Entry &entry) const noexcept -> StringRef
+{
+	// The file may have been edited, an entry reaching past the data is damaged
+	auto offset = entry.position % ch_data_size;
+	auto length = entry.length;
+	if(length == 0 || length > ch_data_size - offset)
+		return StringRef();
+
+	return StringRef(ch_data + offset, length);
+}
@@ -0,0 +1,62 @@
+#include "../headers/arg_index.hpp"
+
+using namespace CPM_TYR_CN;
+
+const std::size_t ArgumentIndex::npos;
+
+void ArgumentIndex::insert(const ArgumentView &arg, std::size_t pos)
+{
+	insert(arg.shortArg(), pos);
+	insert(arg.longArg(), pos);
+	insert(arg.command(), pos);
+}
+
+void ArgumentIndex::insert(StringRef spelling, std::size_t pos)
+{
+	// Empty spellings never match a token and the first registered
+	// argument wins, like the former linear search did
+	if(spelling.empty())
+		return;
+
+	ai_map.emplace(spelling, pos);
+}
+
+auto ArgumentIndex::erase(StringRef spelling, std::size_t pos) -> bool
+{
+	auto iter = ai_map.find(spelling);
+	if(iter == ai_map.end() || iter->second != pos)
+		return false;
+
+	ai_map.erase(iter);
+	return true;
+}
+
+void ArgumentIndex::rebuild(const ArgumentStore &args)
+{
+	clear();
+	ai_map.reserve(args.size() * 3);
+
+	for(auto arg : args)
+		insert(arg, arg.position());
+}
+
+void ArgumentIndex::reserve(std::size_t count)
+{
+	ai_map.reserve(count);
+}
+
+void ArgumentIndex::clear() noexcept
+{
+	ai_map.clear();
+}
+
+auto ArgumentIndex::find(StringRef spelling) const noexcept -> std::size_t
+{
+	auto iter = ai_map.find(spelling);
+	return (iter != ai_map.end()) ? iter->second : npos;
+}
+
+auto ArgumentIndex::size() const noexcept -> std::size_t
+{
+	return ai_map.size();
+}
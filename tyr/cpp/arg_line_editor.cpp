@@ -0,0 +1,531 @@
+#include "../headers/arg_line_editor.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+using namespace CPM_TYR_CN;
+
+namespace
+{
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Raw mode while a line is read, commands run with the normal settings
+class RawMode
+{
+public:
+	RawMode() noexcept :
+		rm_active(false)
+	{
+		if(tcgetattr(STDIN_FILENO, &rm_saved) != 0)
+			return;
+
+		termios raw = rm_saved;
+		raw.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+		raw.c_cflag |= CS8;
+		raw.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+		raw.c_cc[VMIN] = 1;
+		raw.c_cc[VTIME] = 0;
+
+		// Output processing stays on, so '\n' still starts a new line.
+		// TCSADRAIN keeps what was typed ahead.
+		rm_active = (tcsetattr(STDIN_FILENO, TCSADRAIN, &raw) == 0);
+	}
+
+	~RawMode()
+	{
+		if(rm_active)
+			tcsetattr(STDIN_FILENO, TCSADRAIN, &rm_saved);
+	}
+
+	auto active() const noexcept -> bool
+	{
+		return rm_active;
+	}
+
+private:
+	termios rm_saved;
+	bool rm_active;
+};
+
+auto readKey(char &c) -> bool
+{
+	while(true)
+	{
+		auto count = ::read(STDIN_FILENO, &c, 1);
+		if(count == 1)
+			return true;
+		else if(count < 0 && errno == EINTR)
+			continue;
+
+		return false;
+	}
+}
+
+#endif
+
+enum Key : char
+{
+	CTRL_A = 1,
+	CTRL_B = 2,
+	CTRL_C = 3,
+	CTRL_D = 4,
+	CTRL_E = 5,
+	CTRL_F = 6,
+	CTRL_G = 7,
+	CTRL_H = 8,
+	TAB = 9,
+	CTRL_K = 11,
+	CTRL_N = 14,
+	CTRL_P = 16,
+	CTRL_R = 18,
+	CTRL_U = 21,
+	ESC = 27,
+	BACKSPACE = 127
+};
+
+// Words end at blanks and the & and | of command groups
+auto isWordBoundary(char c) noexcept -> bool
+{
+	return c == ' ' || c == '\t' || c == '&' || c == '|';
+}
+
+}
+
+LineEditor::LineEditor(std::size_t history_size) :
+	le_completer(),
+	le_completion(),
+	le_history(),
+	le_history_size(history_size),
+	le_log(nullptr),
+	le_saved(),
+	le_output()
+{
+}
+
+void LineEditor::setCompleter(Completer completer)
+{
+	le_completer = std::move(completer);
+}
+
+void LineEditor::setHistorySize(std::size_t size)
+{
+	le_history_size = size;
+	while(le_history.size() > le_history_size)
+		le_history.pop_front();
+}
+
+void LineEditor::addHistory(const std::string &line)
+{
+	// Repeating the last line does not fill the history
+	if(line.empty() || le_history_size == 0 || (!le_history.empty() && le_history.back() == line))
+		return;
+
+	if(le_history.size() == le_history_size)
+		le_history.pop_front();
+
+	le_history.push_back(line);
+}
+
+auto LineEditor::getHistory() const noexcept -> const std::deque<std::string> &
+{
+	return le_history;
+}
+
+void LineEditor::setHistoryLog(CommandHistory *log)
+{
+	le_log = log;
+	if(!le_log)
+		return;
+
+	// Only as many lines as the history holds, however long the log is
+	auto number = le_log->next() - std::min<std::uint64_t>(le_log->size(), le_history_size);
+	for(; number < le_log->next(); number++)
+		addHistory(le_log->at(number).str());
+}
+
+auto LineEditor::readLine(const std::string &prompt, std::string &line) -> bool
+{
+	bool read;
+	if(isInteractive())
+		read = readRaw(prompt, line);
+	else
+	{
+		std::cout << prompt;
+		read = static_cast<bool>(std::getline(std::cin, line));
+	}
+
+	if(read)
+	{
+		addHistory(line);
+
+		// Repeated lines are logged too, the log is meant to be replayed
+		if(le_log)
+			le_log->append(line);
+	}
+
+	return read;
+}
+
+auto LineEditor::isInteractive() noexcept -> bool
+{
+#if defined(__unix__) || defined(__APPLE__)
+	const char *term = std::getenv("TERM");
+	return isatty(STDIN_FILENO) && isatty(STDOUT_FILENO) && (term == nullptr || std::strcmp(term, "dumb") != 0);
+#else
+	return false;
+#endif
+}
+
+auto LineEditor::readRaw(const std::string &prompt, std::string &line) -> bool
+{
+#if defined(__unix__) || defined(__APPLE__)
+	RawMode raw;
+	if(!raw.active())
+	{
+		std::cout << prompt;
+		return static_cast<bool>(std::getline(std::cin, line));
+	}
+
+	line.clear();
+	std::size_t cursor = 0;
+	std::size_t history_pos = le_history.size();	// The history size means the edited line
+	refresh(prompt, line, cursor);
+
+	char c;
+	while(readKey(c))
+	{
+		switch(c)
+		{
+		case '\r':
+		case '\n':
+			std::cout << '\n' << std::flush;
+			return true;
+		case CTRL_C:
+			// Drops the line but keeps the loop running
+			line.clear();
+			cursor = 0;
+			std::cout << "^C\n";
+			break;
+		case CTRL_D:
+			if(line.empty())
+			{
+				std::cout << '\n' << std::flush;
+				return false;
+			}
+			else if(cursor < line.size())
+				line.erase(cursor, 1);
+
+			break;
+		case CTRL_H:
+		case BACKSPACE:
+			if(cursor > 0)
+				line.erase(--cursor, 1);
+
+			break;
+		case CTRL_A:
+			cursor = 0;
+			break;
+		case CTRL_E:
+			cursor = line.size();
+			break;
+		case CTRL_B:
+			cursor -= (cursor > 0) ? 1 : 0;
+			break;
+		case CTRL_F:
+			cursor += (cursor < line.size()) ? 1 : 0;
+			break;
+		case CTRL_K:
+			line.erase(cursor);
+			break;
+		case CTRL_U:
+			line.erase(0, cursor);
+			cursor = 0;
+			break;
+		case CTRL_P:
+			browse(line, cursor, history_pos, true);
+			break;
+		case CTRL_N:
+			browse(line, cursor, history_pos, false);
+			break;
+		case TAB:
+			complete(line, cursor);
+			break;
+		case CTRL_R:
+		{
+			char key;
+			if(!search(line, cursor, key))
+				return false;
+
+			// Enter runs the line found right away
+			if(key == '\r' || key == '\n')
+			{
+				refresh(prompt, line, cursor);
+				std::cout << '\n' << std::flush;
+				return true;
+			}
+
+			break;
+		}
+		case ESC:
+		{
+			// ESC [ A..D and ESC [ n ~ for arrows, home, end and delete
+			char seq[3];
+			if(!readKey(seq[0]) || !readKey(seq[1]))
+				return false;
+
+			if(seq[0] == '[' && seq[1] >= '0' && seq[1] <= '9')
+			{
+				if(!readKey(seq[2]))
+					return false;
+
+				if(seq[2] == '~')
+				{
+					if(seq[1] == '3' && cursor < line.size())
+						line.erase(cursor, 1);
+					else if(seq[1] == '1' || seq[1] == '7')
+						cursor = 0;
+					else if(seq[1] == '4' || seq[1] == '8')
+						cursor = line.size();
+				}
+			}
+			else if(seq[0] == '[' || seq[0] == 'O')
+			{
+				switch(seq[1])
+				{
+				case 'A':
+					browse(line, cursor, history_pos, true);
+					break;
+				case 'B':
+					browse(line, cursor, history_pos, false);
+					break;
+				case 'C':
+					cursor += (cursor < line.size()) ? 1 : 0;
+					break;
+				case 'D':
+					cursor -= (cursor > 0) ? 1 : 0;
+					break;
+				case 'H':
+					cursor = 0;
+					break;
+				case 'F':
+					cursor = line.size();
+					break;
+				}
+			}
+
+			break;
+		}
+		default:
+			if(static_cast<unsigned char>(c) >= ' ')
+				line.insert(cursor++, 1, c);
+
+			break;
+		}
+
+		refresh(prompt, line, cursor);
+	}
+
+	return false;
+#else
+	std::cout << prompt;
+	return static_cast<bool>(std::getline(std::cin, line));
+#endif
+}
+
+void LineEditor::refresh(const std::string &prompt, const std::string &line, std::size_t cursor)
+{
+	// One write per key: back to the start, the line, clear the rest and
+	// move the cursor back where it belongs
+	le_output.assign("\r");
+	le_output.append(prompt);
+	le_output.append(line);
+	le_output.append("\x1b[K");
+
+	if(cursor < line.size())
+	{
+		le_output.append("\x1b[");
+		le_output.append(std::to_string(line.size() - cursor));
+		le_output.push_back('D');
+	}
+
+	std::cout << le_output << std::flush;
+}
+
+void LineEditor::complete(std::string &line, std::size_t &cursor)
+{
+	if(!le_completer)
+		return;
+
+	std::size_t start = cursor;
+	while(start > 0 && !isWordBoundary(line[start - 1]))
+		start--;
+
+	le_completion.candidates.clear();
+	le_completion.total = 0;
+	le_completion.common.clear();
+	le_completer(StringRef(line.data(), cursor), le_completion);
+
+	if(le_completion.total == 0)
+	{
+		std::cout << '\a';
+		return;
+	}
+
+	// Extend the word as far as all matches agree, a second tab lists them
+	if(le_completion.common.size() > cursor - start)
+	{
+		line.replace(start, cursor - start, le_completion.common);
+		cursor = start + le_completion.common.size();
+
+		if(le_completion.total != 1)
+			return;
+	}
+
+	if(le_completion.total == 1)
+	{
+		if(cursor == line.size() || line[cursor] != ' ')
+			line.insert(cursor, 1, ' ');
+
+		cursor++;
+		return;
+	}
+
+	// Several matches, list them below the line
+	std::size_t column = 0;
+	std::cout << '\n';
+	for(auto &candidate : le_completion.candidates)
+	{
+		if(column != 0 && column + candidate.size() + 2 > 80)
+		{
+			std::cout << '\n';
+			column = 0;
+		}
+
+		std::cout << candidate << "  ";
+		column += candidate.size() + 2;
+	}
+
+	if(le_completion.total > le_completion.candidates.size())
+		std::cout << "\n... and " << le_completion.total - le_completion.candidates.size() << " more";
+
+	std::cout << '\n';
+}
+
+auto LineEditor::search(std::string &line, std::size_t &cursor, char &key) -> bool
+{
+#if defined(__unix__) || defined(__APPLE__)
+	// Every key refines the search from the newest line, Ctrl-R goes on to
+	// older matches. Ctrl-G and Ctrl-C restore the line, any other key
+	// keeps the match for editing.
+	const std::string original = line;
+	const std::uint64_t none = CommandHistory::npos;
+	std::string text;
+	std::string found;
+	std::uint64_t match = none;
+	bool failed = false;
+
+	while(true)
+	{
+		le_output.assign(failed ? "\r(failed reverse-i-search)`" : "\r(reverse-i-search)`");
+		le_output.append(text).append("': ").append(found).append("\x1b[K");
+		std::cout << le_output << std::flush;
+
+		if(!readKey(key))
+			return false;
+
+		std::uint64_t before = none;
+		if(key == CTRL_R)
+			before = match;
+		else if(key == CTRL_H || key == BACKSPACE)
+		{
+			if(!text.empty())
+				text.pop_back();
+		}
+		else if(key == CTRL_G || key == CTRL_C)
+		{
+			line = original;
+			cursor = line.size();
+			key = 0;
+			return true;
+		}
+		else if(static_cast<unsigned char>(key) >= ' ')
+			text.push_back(key);
+		else
+		{
+			if(match != none)
+				line = found;
+
+			cursor = line.size();
+			return true;
+		}
+
+		// The last match stays while nothing older is found
+		std::string older;
+		auto result = (key != CTRL_R || match != none) ? findOlder(text, before, older) : none;
+		failed = (result == none);
+		if(!failed)
+		{
+			match = result;
+			found.swap(older);
+		}
+	}
+#else
+	(void)line;
+	(void)cursor;
+	key = 0;
+	return true;
+#endif
+}
+
+auto LineEditor::findOlder(StringRef text, std::uint64_t before, std::string &found) const -> std::uint64_t
+{
+	if(le_log)
+	{
+		auto number = le_log->searchBackward(text, before);
+		if(number != CommandHistory::npos)
+			found = le_log->at(number).str();
+
+		return number;
+	}
+
+	// Without a log the lines in memory are numbered by their position
+	for(auto pos = std::min<std::uint64_t>(before, le_history.size()); pos > 0; pos--)
+	{
+		auto &line = le_history[pos - 1];
+		if(line.find(text.data(), 0, text.size()) != std::string::npos)
+		{
+			found = line;
+			return pos - 1;
+		}
+	}
+
+	return CommandHistory::npos;
+}
+
+void LineEditor::browse(std::string &line, std::size_t &cursor, std::size_t &history_pos, bool older)
+{
+	if(older ? history_pos == 0 : history_pos >= le_history.size())
+		return;
+
+	if(history_pos == le_history.size())
+		le_saved = line;
+
+	if(older)
+		history_pos--;
+	else
+		history_pos++;
+
+	// assign() keeps the capacity of the line
+	line.assign((history_pos < le_history.size()) ? le_history[history_pos] : le_saved);
+	cursor = line.size();
+}
@@ -0,0 +1,94 @@
+#include "../headers/arg_output.hpp"
+
+#include <iostream>
+#include <mutex>
+
+using namespace CPM_TYR_CN;
+
+namespace
+{
+
+thread_local std::streambuf *output_target = nullptr;
+
+// Stands in for the buffer of std::cout and passes every write on to the
+// target of the writing thread. It buffers nothing itself, so a thread
+// without a target writes exactly as it did before.
+class RoutingBuffer : public std::streambuf
+{
+public:
+	explicit RoutingBuffer(std::streambuf *fallback) noexcept :
+		rb_fallback(fallback),
+		rb_mutex()
+	{
+	}
+
+protected:
+	auto overflow(int_type c) -> int_type override
+	{
+		if(traits_type::eq_int_type(c, traits_type::eof()))
+			return traits_type::not_eof(c);
+
+		char ch = traits_type::to_char_type(c);
+		return (write(&ch, 1) == 1) ? c : traits_type::eof();
+	}
+
+	auto xsputn(const char *data, std::streamsize count) -> std::streamsize override
+	{
+		return write(data, count);
+	}
+
+	auto sync() -> int override
+	{
+		auto target = output_target;
+		if(target == nullptr)
+			return rb_fallback->pubsync();
+
+		std::lock_guard<std::mutex> lock(rb_mutex);
+		return target->pubsync();
+	}
+
+private:
+	std::streambuf *rb_fallback;
+	std::mutex rb_mutex;		// Threads of one group share their target
+
+private:
+	auto write(const char *data, std::streamsize count) -> std::streamsize
+	{
+		auto target = output_target;
+		if(target == nullptr)
+			return rb_fallback->sputn(data, count);
+
+		std::lock_guard<std::mutex> lock(rb_mutex);
+		return target->sputn(data, count);
+	}
+};
+
+}
+
+ThreadOutput::ThreadOutput(std::streambuf *buffer) :
+	to_previous(output_target)
+{
+	// std::cout is left alone until something is redirected
+	if(buffer != nullptr)
+		route();
+
+	output_target = buffer;
+}
+
+ThreadOutput::~ThreadOutput()
+{
+	output_target = to_previous;
+}
+
+auto ThreadOutput::current() noexcept -> std::streambuf *
+{
+	return output_target;
+}
+
+void ThreadOutput::route()
+{
+	// Never freed, std::cout is still flushed after static destructors ran
+	static RoutingBuffer *routing = new RoutingBuffer(std::cout.rdbuf());
+	static std::once_flag routed;
+	std::call_once(routed, []() { std::cout.rdbuf(routing); });
+}
@@ -1,665 +1,2525 @@
 #include "../headers/arg_parser.hpp"
 #include "../headers/arg_exception.hpp"
+#include "../headers/arg_output.hpp"
+#include "../headers/arg_server.hpp"
 
 #include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
-#include <iomanip>
 #include <sstream>
-#include <iterator>
 #include <locale>
-#include <future>
+#include <mutex>
+#include <thread>
 
 using namespace CPM_TYR_CN;
 
-ArgumentParser::ArgumentParser(std::string exec_name) noexcept :
-	args(),
-	parsed()
+namespace
 {
-	addBaseArgs(std::move(exec_name));
+
+// The spelling flags always follow which spellings are set
+auto spellingFlags(ArgumentFlags flags, StringRef short_arg, StringRef long_arg, StringRef command) noexcept -> ArgumentFlags
+{
+	flags &= ~static_cast<unsigned int>(ArgumentFlags::SHORT_ARG | ArgumentFlags::LONG_ARG | ArgumentFlags::COMMAND);
+	if(!short_arg.empty())
+		flags |= ArgumentFlags::SHORT_ARG;
+	if(!long_arg.empty())
+		flags |= ArgumentFlags::LONG_ARG;
+	if(!command.empty())
+		flags |= ArgumentFlags::COMMAND;
+
+	return flags;
 }
 
-ArgumentParser::ArgumentParser(std::vector<Argument> &args_v, std::string exec_name) noexcept :
-	args(args_v.begin(), args_v.end()),
-	parsed()
+void normalizeFlags(Argument &arg) noexcept
 {
-	addBaseArgs(std::move(exec_name));
+	arg.flags = spellingFlags(arg.flags, arg.short_arg, arg.long_arg, arg.command);
+}
 
-	args.insert(args.end(), args_v.begin(), args_v.end());
+const std::size_t script_block_size = 1 << 16;
 
+inline auto allowsUserData(ArgumentFlags flags) noexcept -> bool
+{
+	return flags.isUserDataAllowed() || flags.isUserDataRequired();
 }
 
-ArgumentParser::ArgumentParser(const ArgumentParser& orig) noexcept :
-	args(orig.args),
-	parsed(orig.parsed)
+inline auto looksLikeOption(StringRef token) noexcept -> bool
 {
+	return token.size() > 1 && token[0] == '-';
 }
 
-ArgumentParser::~ArgumentParser() 
+// -5, -0.5 or -.5 are values, not options
+inline auto looksLikeNegativeNumber(StringRef token) noexcept -> bool
 {
-	args.clear();
-	parsed.clear();
+	if(!looksLikeOption(token))
+		return false;
+
+	auto first = (token.size() > 2 && token[1] == '.') ? token[2] : token[1];
+	return first >= '0' && first <= '9';
 }
 
-void ArgumentParser::add(std::string s_arg, std::string l_arg, std::string cmd, std::string desc, std::string ex, ArgumentFlags flags, std::function<void(std::string)> func) noexcept
+auto typeName(ArgumentValue::Type type, const StringRef *choices, std::size_t choice_count) -> std::string
 {
-    Argument arg;
-    arg.short_arg = s_arg;
-    arg.long_arg = l_arg;
-    arg.command = cmd;
-    arg.description = desc;
-    arg.example = ex;
-	arg.func = func;
-	arg.flags = flags;
+	switch(type)
+	{
+	case ArgumentValue::INT:
+	case ArgumentValue::INT8:
+	case ArgumentValue::INT16:
+	case ArgumentValue::INT32:
+	case ArgumentValue::UINT8:
+	case ArgumentValue::UINT16:
+	case ArgumentValue::UINT32:
+	case ArgumentValue::UINT64:
+		return "integer";
+	case ArgumentValue::DOUBLE:
+		return "number";
+	case ArgumentValue::BOOL:
+		return "boolean";
+	case ArgumentValue::DURATION:
+		return "duration";
+	case ArgumentValue::BYTE_SIZE:
+		return "byte size";
+	case ArgumentValue::ENUM:
+	{
+		std::string names;
+		for(std::size_t pos = 0; pos < choice_count; pos++)
+			names.append(names.empty() ? "" : "|").append(choices[pos].data(), choices[pos].size());
+		return names;
+	}
+	default:
+		return "string";
+	}
+}
+
+// Converts the user data of a typed argument once. Strings are no typed values.
+auto toValue(const ArgumentView &arg, StringRef spelling, StringRef user_data) -> ArgumentResult<ArgumentValue>
+{
+	ArgumentValue value;
+	if(user_data.empty() || !arg.valueFunc())
+		return value;
 
-	arg.flags &= (ArgumentFlags::SHORT_ARG | ArgumentFlags::LONG_ARG | ArgumentFlags::COMMAND);
-	if(!arg.short_arg.empty())
-		arg.flags |= ArgumentFlags::SHORT_ARG;
-	if(!arg.short_arg.empty())
-		arg.flags |= ArgumentFlags::LONG_ARG;
-	if(!arg.short_arg.empty())
-		arg.flags |= ArgumentFlags::COMMAND;
+	if(!ArgumentValue::convert(arg.valueType(), user_data, arg.choices(), arg.choiceCount(), value))
+		return ArgumentException(ArgumentException::INVALID_VALUE_ERROR, "The value " + user_data.str() + " of " + spelling.str() + " is no valid "
+			+ typeName(arg.valueType(), arg.choices(), arg.choiceCount()));
 
-    args.push_back(arg);
+	return value;
 }
 
-void ArgumentParser::add(Argument &arg) noexcept
+// --output is output, commands and short spellings stand for themselves
+auto configKey(const ArgumentView &arg) noexcept -> StringRef
 {
-	arg.flags &= (ArgumentFlags::SHORT_ARG | ArgumentFlags::LONG_ARG | ArgumentFlags::COMMAND);
-	if(!arg.short_arg.empty())
-		arg.flags |= ArgumentFlags::SHORT_ARG;
-	if(!arg.short_arg.empty())
-		arg.flags |= ArgumentFlags::LONG_ARG;
-	if(!arg.short_arg.empty())
-		arg.flags |= ArgumentFlags::COMMAND;
+	auto spelling = !arg.longArg().empty() ? arg.longArg() : (!arg.command().empty() ? arg.command() : arg.shortArg());
+	while(!spelling.empty() && spelling[0] == '-')
+		spelling = spelling.substr(1);
 
-    args.push_back(arg);
+	return spelling;
 }
- 
-void ArgumentParser::add(std::vector<Argument> &args_v) noexcept
+
+inline auto isTrue(StringRef value) noexcept -> bool
 {
-    args.reserve(args_v.size());
-    args.insert(args.end(), args_v.begin(), args_v.end());
+	return value == StringRef("true") || value == StringRef("yes") || value == StringRef("on") || value == StringRef("1");
+}
 
-	for(auto &arg : args)
-	{
-		arg.flags &= (ArgumentFlags::SHORT_ARG | ArgumentFlags::LONG_ARG | ArgumentFlags::COMMAND);
-		if(!arg.short_arg.empty())
-			arg.flags |= ArgumentFlags::SHORT_ARG;
-		if(!arg.short_arg.empty())
-			arg.flags |= ArgumentFlags::LONG_ARG;
-		if(!arg.short_arg.empty())
-			arg.flags |= ArgumentFlags::COMMAND;
-	}
+auto missingPipeCommand() -> ArgumentException
+{
+	return ArgumentException(ArgumentException::SYNTAX_ERROR, "A command has to follow |");
 }
 
-void ArgumentParser::remove(std::string matching_str)
+inline auto isSeparator(const CommandToken &token) noexcept -> bool
 {
-    std::remove_if(args.begin(), args.end(), [&](Argument &arg) -> bool
-	{
-		return compareArgs(arg, matching_str);
-	});
+	return token.kind == CommandToken::AND || token.kind == CommandToken::PARALLEL;
 }
 
-void ArgumentParser::remove(Argument &arg)
+// & and && need a command on both sides, which is checked before anything runs
+auto checkSeparators(const std::vector<CommandToken> &tokens) -> ArgumentResult<void>
 {
-	// If compareArgs() returns true remove
-	std::remove_if(args.begin(), args.end(), [&](Argument &current_arg) -> bool
+	for(std::size_t pos = 0; pos < tokens.size(); pos++)
 	{
-		return compareArgs(current_arg, arg);
-	});
+		if(!isSeparator(tokens[pos]))
+			continue;
+
+		std::string name = (tokens[pos].kind == CommandToken::AND) ? "&&" : "&";
+		if(pos == 0 || isSeparator(tokens[pos - 1]))
+			return ArgumentException(ArgumentException::SYNTAX_ERROR, "A command has to come before " + name);
+		else if(pos + 1 == tokens.size())
+			return ArgumentException(ArgumentException::SYNTAX_ERROR, "A command has to follow " + name);
+	}
+
+	return ArgumentResult<void>();
 }
 
-void ArgumentParser::remove(std::vector<Argument> &args_v)
+auto missingValues(StringRef spelling, ArgumentArity arity) -> ArgumentException
 {
-	// Set iterators to first position
-	auto other_iter = args_v.begin();
-	auto iter = args.begin();
+	return ArgumentException(ArgumentException::NO_USER_DATA_ERROR, "The argument " + spelling.str() + " requires "
+		+ (arity.min() == arity.max() ? "" : "at least ") + std::to_string(arity.min()) + (arity.min() == 1 ? " value" : " values"));
+}
 
-	// Loop through the private Argument vector
-	while(iter != args.end())
+inline void invoke(const ArgumentView &arg, StringRef user_data, const ArgumentValue &value, ArgumentValues values, CommandStream *stream)
+{
+	if(arg.flags().isStream())
 	{
-		iter = std::remove_if(args.begin(), args.end(), [&](Argument &arg) -> bool
-		{
-			// Compare the current element of 'args' with next element of 'args_v'
-			if(compareArgs(arg, *other_iter))
-			{
-				// If both are equal remove the current and compare the next element of 'args_v' next time
-				other_iter++;
-				return true;
-			}
-			else
-				return false;
-		});
+		// Outside a pipeline there are no lines to read and the output goes to std::cout
+		CommandStream alone(user_data, nullptr, nullptr);
+		arg.streamFunc()(stream != nullptr ? *stream : alone);
 	}
+	else if(arg.flags().isVariadic())
+		arg.valuesFunc()(values);
+	else if(arg.valueFunc())
+		arg.valueFunc()(value);
+	else
+		arg.func()(user_data);
 }
 
-auto ArgumentParser::getArgument(std::string match_str) const -> const Argument &
+// 850ns, 12.3us, 4.56ms or 1.20s
+auto formatDuration(std::uint64_t ns) -> std::string
 {
-	auto iter = std::find_if(args.begin(), args.end(), [&](const Argument &current_arg)
-	{
-		return compareArgs(current_arg, match_str);
-	});
-	
-	if(iter == args.end())
-		throw ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, "The argument " + match_str + " could not be found");
+	char buffer[32];
+	if(ns < 1000)
+		std::snprintf(buffer, sizeof(buffer), "%lluns", static_cast<unsigned long long>(ns));
+	else if(ns < 1000000)
+		std::snprintf(buffer, sizeof(buffer), "%.1fus", ns / 1e3);
+	else if(ns < 1000000000)
+		std::snprintf(buffer, sizeof(buffer), "%.2fms", ns / 1e6);
+	else
+		std::snprintf(buffer, sizeof(buffer), "%.2fs", ns / 1e9);
 
-	return *iter;
+	return buffer;
 }
 
-auto ArgumentParser::getArgument(std::string match_str) -> Argument &
+auto errorName(std::size_t slot) -> const char *
 {
-	auto iter = std::find_if(args.begin(), args.end(), [&](Argument &current_arg)
-	{
-		return compareArgs(current_arg, match_str);
-	});
-
-	if(iter == args.end())
-		throw ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, "The argument " + match_str + " could not be found");
+	static const char *names[] = { "ARG_NOT_FOUND_ERROR", "NO_USER_DATA_ERROR", "ALIAS_ERROR", "TOO_MANY_ARGS_ERROR",
+		"SYNTAX_ERROR", "IO_ERROR", "GROUP_ERROR", "INVALID_VALUE_ERROR", "UNKNOWN" };
+	static_assert(sizeof(names) / sizeof(names[0]) == CommandStats::error_slots, "Every error slot needs a name");
 
-	return *iter;
+	return names[slot];
 }
 
-auto ArgumentParser::getUserData(std::string match_str) const -> std::string
+// Counts a function while it is called, on whatever thread calls it. A
+// removal only compacts the registry once no function of any group or
+// pipeline thread runs anymore.
+class RunningScope
 {
-	auto iter = std::find_if(parsed.begin(), parsed.end(), [&](const std::tuple<ArgIter, std::string> &current_res)
+public:
+	explicit RunningScope(std::atomic<std::size_t> &running) noexcept :
+		rs_running(running)
 	{
-		ArgIter arg = std::get<0>(current_res);
-		if(arg->command == match_str)
-			return true;
-		else if(arg->long_arg == match_str)
-			return true;
-		else if(arg->short_arg == match_str)
-			return true;
-		else
-			return false;
-	});
+		rs_running.fetch_add(1);
+	}
 
-	if(iter == parsed.end())
-		throw ArgumentException(ArgumentException::NO_USER_DATA_ERROR, "The user has no data supplied");
+	~RunningScope()
+	{
+		rs_running.fetch_sub(1);
+	}
 
-	return std::get<1>(*iter);
-}
+private:
+	std::atomic<std::size_t> &rs_running;
+};
 
-auto ArgumentParser::getUserData(Argument &arg) const -> std::string
+void insertSpellings(ArgumentTrie &trie, const ArgumentView &arg)
 {
-	auto iter = std::find_if(parsed.begin(), parsed.end(), [&](const std::tuple<ArgIter, std::string> &current_res)
-	{
-		return compareArgs(*std::get<0>(current_res), arg);
-	});
-
-	if(iter == parsed.end())
-		throw ArgumentException(ArgumentException::NO_USER_DATA_ERROR, "The user has no data supplied");
+	trie.insert(arg.shortArg());
+	trie.insert(arg.longArg());
+	trie.insert(arg.command());
+}
 
-	return std::get<1>(*iter);
+inline auto hasSpelling(const ArgumentView &arg, StringRef spelling) noexcept -> bool
+{
+	return !spelling.empty() && (arg.command() == spelling || arg.longArg() == spelling || arg.shortArg() == spelling);
 }
 
-void ArgumentParser::setAlias(std::string existing_arg, Argument &alias)
+// Describes an existing argument by its most meaningful spelling
+auto primarySpelling(const ArgumentView &arg) -> std::string
 {
-	auto iter = std::find_if(args.begin(), args.end(), [&](Argument &arg)
-	{
-		if(arg.command == existing_arg)
-			return true;
-		else if(arg.long_arg == existing_arg)
-			return true;
-		else if(arg.short_arg == existing_arg)
-			return true;
-		else
-			return false;
-	});
+	auto flags = arg.flags();
+	return ((flags & ArgumentFlags::COMMAND) ? arg.command() : ((flags & ArgumentFlags::LONG_ARG) ? arg.longArg() : arg.shortArg())).str();
+}
 
-	if(iter == args.end())
-		throw ArgumentException(ArgumentException::ALIAS_ERROR, "The argument " + existing_arg + " does not exist");
+// The lines of a concurrent parser may be run by many threads at once
+thread_local CommandTokenizer thread_tokenizer;
 
-	alias.flags = iter->flags;
-	alias.flags &= (ArgumentFlags::SHORT_ARG | ArgumentFlags::LONG_ARG | ArgumentFlags::COMMAND);
-	if(!alias.short_arg.empty())
-		alias.flags |= ArgumentFlags::SHORT_ARG;
-	if(!alias.short_arg.empty())
-		alias.flags |= ArgumentFlags::LONG_ARG;
-	if(!alias.short_arg.empty())
-		alias.flags |= ArgumentFlags::COMMAND;
+// Set while a thread replays a history
+thread_local bool replaying = false;
 
-	alias.func = iter->func;
-	alias.example = iter->example;
-	alias.data_info = iter->data_info;
+thread_local const std::function<void(int)> *exit_hook = nullptr;
 
-	if(alias.description.empty())
-	{
-		// Choose the most meaningful and non-empty argument		[A bit ugly but short]
-		// At first check if COMMAND flag is set. If not no command is set
-		std::string &arg_descript = (iter->flags & ArgumentFlags::COMMAND) ? iter->command : 
-			// Then check if LONG_ARG flags is set. If not there is also no long argument
-			// so use short argument as description
-			((iter->flags & ArgumentFlags::LONG_ARG) ? iter->long_arg : iter->short_arg);
-		alias.description = "This is an alias for " + arg_descript;
-	}
+const std::size_t history_lines_shown = 20;
 
-	if(alias.long_description.empty())
-	{
-		std::string &arg_descript = (iter->flags & ArgumentFlags::COMMAND) ? iter->command : ((iter->flags & ArgumentFlags::LONG_ARG) ? iter->long_arg : iter->short_arg);
-		alias.long_description = "This is an alias for " + arg_descript + ". See the help for " + arg_descript + " for more information.";
-	}
 }
 
-void ArgumentParser::setAlias(Argument &existing_arg, Argument &alias)
+struct ArgumentParser::Concurrency
 {
-	alias.flags = existing_arg.flags;
-	alias.flags &= (ArgumentFlags::SHORT_ARG | ArgumentFlags::LONG_ARG | ArgumentFlags::COMMAND);
-	if(!alias.short_arg.empty())
-		alias.flags |= ArgumentFlags::SHORT_ARG;
-	if(!alias.short_arg.empty())
-		alias.flags |= ArgumentFlags::LONG_ARG;
-	if(!alias.short_arg.empty())
-		alias.flags |= ArgumentFlags::COMMAND;
-
-	auto iter = std::find_if(args.begin(), args.end(), [&](Argument &arg)
+	explicit Concurrency(std::shared_ptr<SnapshotDomain> domain) noexcept :
+		mutex(),
+		depth(0),
+		changed(false),
+		owner(false),
+		snapshot(std::move(domain))
 	{
-		return compareArgs(existing_arg, arg);
-	});
-
-	if(iter == args.end())
-		throw ArgumentException(ArgumentException::ALIAS_ERROR, "The specified argument does not exist");
+	}
 
-	alias.func = iter->func;
-	alias.example = iter->example;
-	alias.data_info = iter->data_info;
+	std::recursive_mutex mutex;		// Changes and reads of the parser's own registry
+	std::size_t depth;				// Of nested RegistryLocks
+	bool changed;
+	bool owner;						// Of the domain, which the groups share
+	SnapshotCell<ArgumentParser> snapshot;
+};
 
-	if(alias.description.empty())
+// Serializes changes of a concurrent parser, the outermost lock publishes
+// them. Does nothing for other parsers.
+class ArgumentParser::RegistryLock
+{
+public:
+	explicit RegistryLock(const ArgumentParser &parser) :
+		rl_parser(parser),
+		rl_locked(parser.lockRegistry())
 	{
-		// Choose the most meaningful and non-empty argument		[A bit ugly but short]
-		// At first check if COMMAND flag is set. If not no command is set
-		std::string &arg_descript = (iter->flags & ArgumentFlags::COMMAND) ? iter->command :
-			// Then check if LONG_ARG flags is set. If not there is also no long argument
-			// so use short argument as description
-			((iter->flags & ArgumentFlags::LONG_ARG) ? iter->long_arg : iter->short_arg);
-		alias.description = "This is an alias for " + arg_descript;
 	}
 
-	if(alias.long_description.empty())
+	~RegistryLock()
 	{
-		std::string &arg_descript = (iter->flags & ArgumentFlags::COMMAND) ? iter->command : ((iter->flags & ArgumentFlags::LONG_ARG) ? iter->long_arg : iter->short_arg);
-		alias.long_description = "This is an alias for " + arg_descript + ". See the help for " + arg_descript + " for more information.";
+		if(rl_locked)
+			rl_parser.unlockRegistry();
 	}
 
-	args.push_back(alias);
+	RegistryLock(const RegistryLock &) = delete;
+	auto operator =(const RegistryLock &) -> RegistryLock & = delete;
+
+private:
+	const ArgumentParser &rl_parser;
+	bool rl_locked;
+};
+
+ArgumentParser::ExitHook::ExitHook(const std::function<void(int)> *hook) noexcept :
+	eh_previous(exit_hook)
+{
+	exit_hook = hook;
 }
 
-void ArgumentParser::parse(int argc, char **argv, bool execute_funcs)
+ArgumentParser::ExitHook::~ExitHook()
 {
-	saveExecName(argv[0]);
+	exit_hook = eh_previous;
+}
 
-    for(unsigned int i = 0; i < argc; i++)
-    {
-		std::string arg_str = argv[i];
-		auto iter = std::find_if(args.begin(), args.end(), [&](Argument &arg)
-		{
-			if(arg.command == arg_str)
-				return true;
-			else if(arg.long_arg == arg_str)
-				return true;
-			else if(arg.short_arg == arg_str)
-				return true;
-			else
-				return false;
-		});
+auto ArgumentParser::ExitHook::current() noexcept -> const std::function<void(int)> *
+{
+	return exit_hook;
+}
 
-		if(iter != args.end())
-		{
-			if(iter->flags.isUserDataAllowed())
-			{
-				std::string user_data = argv[++i];
-				if(compareArgs(*iter, user_data))
-					argv--;	
+ArgumentParser::ArgumentParser(std::string exec_name) noexcept :
+	args(),
+	index(),
+	trie(),
+	parse_results(),
+	parse_mutex(),
+	response_depth(ArgvReader::default_max_depth),
+	config(),
+	pool(),
+	pool_workers(std::max(std::thread::hardware_concurrency(), 1u)),
+	stats(),
+	line_editor(),
+	history(),
+	help_handle(),
+	running(0),
+	groups(),
+	concurrency(),
+	origin(nullptr)
+{
+	addBaseArgs(std::move(exec_name));
+}
 
-				if(execute_funcs)
-					iter->func(user_data);
+ArgumentParser::ArgumentParser(std::vector<Argument> &args_v, std::string exec_name) noexcept :
+	args(),
+	index(),
+	trie(),
+	parse_results(),
+	parse_mutex(),
+	response_depth(ArgvReader::default_max_depth),
+	config(),
+	pool(),
+	pool_workers(std::max(std::thread::hardware_concurrency(), 1u)),
+	stats(),
+	line_editor(),
+	history(),
+	help_handle(),
+	running(0),
+	groups(),
+	concurrency(),
+	origin(nullptr)
+{
+	addBaseArgs(std::move(exec_name));
+	add(args_v);
+}
 
-				parsed.push_back(std::tuple<ArgIter, std::string>(iter, user_data));
-			}
-			else
-			{
-				if(execute_funcs)
-					iter->func("");
+ArgumentParser::ArgumentParser(const ArgumentParser& orig) noexcept :
+	args(orig.args),
+	index(),
+	trie(),
+	parse_results(),
+	parse_mutex(),
+	response_depth(orig.response_depth),
+	config(orig.config),
+	pool(),
+	pool_workers(orig.pool_workers),
+	stats(orig.stats ? std::make_shared<CommandStats>(orig.args.slotCount()) : nullptr),
+	line_editor(),
+	history(),
+	help_handle(orig.help_handle),
+	running(0),
+	groups(),
+	concurrency(),
+	origin(nullptr)
+{
+	// The copied store is compacted but keeps the handles of the results
+	{
+		std::lock_guard<std::mutex> lock(orig.parse_mutex);
+		parse_results = orig.parse_results;
+	}
 
-				parsed.push_back(std::tuple<ArgIter, std::string>(iter, ""));
-			}
-		}
-    }
+	index.rebuild(args);
+	for(auto arg : args)
+		insertSpellings(trie, arg);
+
+	// Groups already in use are copied, the others stay lazy
+	for(auto &orig_group : orig.groups)
+		groups.push_back(CommandGroup{ orig_group.handle, orig_group.factory, orig_group.parser ? std::make_shared<ArgumentParser>(*orig_group.parser) : nullptr });
 }
 
-auto ArgumentParser::loop(int argc, char **argv, bool catch_except) -> int
+ArgumentParser::ArgumentParser(std::string exec_name, Scope) noexcept :
+	args(),
+	index(),
+	trie(),
+	parse_results(),
+	parse_mutex(),
+	response_depth(ArgvReader::default_max_depth),
+	config(),
+	exec_name(exec_name),
+	exec_path(std::move(exec_name)),
+	pool(),
+	pool_workers(1),
+	stats(),
+	line_editor(0),
+	history(),
+	help_handle(),
+	running(0),
+	groups(),
+	concurrency(),
+	origin(nullptr)
 {
-	parse(argc, argv);
-
-	std::string output = exec_name;
-	output.append(" > ");
+	addHelpArg();
+}
 
-	std::string input;	
+ArgumentParser::ArgumentParser(const ArgumentParser &orig, Scope) noexcept :
+	args(orig.args),
+	index(),
+	trie(),
+	parse_results(),
+	parse_mutex(),
+	response_depth(orig.response_depth),
+	config(orig.config),
+	exec_name(orig.exec_name),
+	exec_path(orig.exec_path),
+	pool(orig.pool),
+	pool_workers(orig.pool_workers),
+	stats(orig.stats),
+	line_editor(0),
+	history(),
+	help_handle(orig.help_handle),
+	running(0),
+	groups(),
+	concurrency(),
+	origin(const_cast<ArgumentParser *>(&orig))
+{
+	// The functions still belong to 'orig', so the built-in ones work on it
+	index.rebuild(args);
+	for(auto arg : args)
+		insertSpellings(trie, arg);
+
+	// Groups not created yet are created by 'orig'
+	groups.reserve(orig.groups.size());
+	for(auto &orig_group : orig.groups)
+		groups.push_back(CommandGroup{ orig_group.handle, nullptr, orig_group.parser });
+}
 
-	bool exit = false;
-	while(!exit)
+ArgumentParser::~ArgumentParser() 
+{
+	if(concurrency && concurrency->owner)
 	{
-		std::cout << output;
+		// Retired snapshots hold on to groups, which retire their own snapshots
+		auto domain = concurrency->snapshot.domain();
+		concurrency.reset();
+		groups.clear();
+		domain->drain();
+	}
 
-		std::string cmdline;
-		std::getline(std::cin, cmdline);
+	args.clear();
+	index.clear();
+	trie.clear();
+	parse_results.parsed.clear();
+	parse_results.positional.clear();
+	groups.clear();
+}
 
-		if(!catch_except)	
-			parseAndRun(cmdline);
-		else
-		{
-			try
-			{
-				parseAndRun(cmdline);
-			}
-			catch(const ArgumentException &e)
-			{
-				if(e.code() == ArgumentException::TOO_MANY_ARGS_ERROR)
-					std::cout << "ERROR: Please specify multiple arguments as following: arg1 && arg2" << std::endl;
-				else
-					std::cout << e.what();
-			}
-		}
-	}
+auto ArgumentParser::add(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, ArgumentFunc func) noexcept -> ArgumentHandle
+{
+	RegistryLock lock(*this);
+	auto handle = args.emplace(s_arg, l_arg, cmd, desc, ex, flags, std::move(func));
+	registerLast();
 
-	return 0;
+	return handle;
 }
 
-auto ArgumentParser::compareArgs(const Argument &arg, std::string &str) const noexcept -> bool
+auto ArgumentParser::add(const Argument &arg) noexcept -> ArgumentHandle
 {
-	if(arg.command == str)
-		return true;
-	else if(arg.short_arg == str)
-		return true;
-	else if(arg.long_arg == str)
-		return true;
-	else if(arg.description == str)
-		return true;
-	else if(arg.example == str)
-		return true;
-	else 
-		return false;
+	RegistryLock lock(*this);
+	return pushArgument(arg);
 }
 
-auto ArgumentParser::compareArgs(Argument &arg, Argument &other_arg) const noexcept -> bool
+auto ArgumentParser::add(Argument &&arg) noexcept -> ArgumentHandle
 {
-	if(arg.command != other_arg.command)
-		return false;
-	else if(arg.short_arg != other_arg.short_arg)
-		return false;
-	else if(arg.long_arg != other_arg.long_arg)
-		return false;
-	else if(arg.description != other_arg.description)
-		return false;
-	else if(arg.example != other_arg.example)
-		return false;
-	else if(arg.flags != other_arg.flags)
-		return false;
-	else
-		return true;
+	RegistryLock lock(*this);
+	return pushArgument(std::move(arg));
 }
 
-void ArgumentParser::addBaseArgs(std::string &&prog_name) noexcept
+void ArgumentParser::add(const std::vector<Argument> &args_v) noexcept
 {
-	exec_path = prog_name;
-	exec_name = exec_path.substr(exec_path.find_last_of("\\") + 1, exec_path.size());
+	RegistryLock lock(*this);
+	reserve(args_v.size());
 
-	Argument help_arg;
-	help_arg.short_arg = "-h";
-	help_arg.long_arg = "--help";
-	help_arg.command = "help";
-	help_arg.data_info = "command";
-	help_arg.description = "Shows information for registered commands";
-	help_arg.example = exec_name + " help";
-	help_arg.flags |= (ArgumentFlags::SHORT_ARG | 
-		ArgumentFlags::LONG_ARG |
-		ArgumentFlags::COMMAND	| 
-		ArgumentFlags::OPTIONAL | 
-		ArgumentFlags::USER_DATA_ALLOWED);
-	help_arg.func = [&](std::string string)
-	{
-		if(string.empty())
-			help();
-		else
-			help(string);
-	};
-	args.push_back(help_arg);
+	for(auto &arg : args_v)
+		pushArgument(arg);
+}
 
-	Argument exit_arg;
-	exit_arg.command = "exit";
-	exit_arg.description = "Exits this application";
-	exit_arg.data_info = "exit_code";
-	exit_arg.example = exec_name + " > exit";
-	exit_arg.flags |= (ArgumentFlags::COMMAND |
-		ArgumentFlags::OPTIONAL |
-		ArgumentFlags::USER_DATA_ALLOWED);
-	exit_arg.func = [&](std::string string)
-	{
-		int exit_code = 0;
-		if(!string.empty())
-			exit_code = std::stoi(string);
+void ArgumentParser::add(std::vector<Argument> &&args_v) noexcept
+{
+	RegistryLock lock(*this);
+	reserve(args_v.size());
 
-		exit(exit_code);
-	};
-	args.push_back(exit_arg);
+	for(auto &arg : args_v)
+		pushArgument(std::move(arg));
 
-	Argument close_alias;
-	close_alias.command = "close";
-	close_alias.example = exec_name + " > close";
-	setAlias(exit_arg, close_alias);
+	args_v.clear();
 }
 
-void ArgumentParser::saveExecName(std::string name) noexcept
+void ArgumentParser::reserve(std::size_t count)
 {
-	if(exec_path.empty())
-		exec_path = name;
+	RegistryLock lock(*this);
+	const std::size_t wanted = args.recordCount() + count;
+	if(wanted <= args.capacity())
+		return;
+
+	// Reserving exactly what every small batch needs would copy the whole
+	// registry per batch, so grow at least by half like the vectors do
+	const std::size_t capacity = std::max(wanted, args.capacity() + args.capacity() / 2);
+	args.reserve(capacity);
+	index.reserve(capacity * 3);
+}
 
-	if(exec_name.empty())
-		exec_name = exec_path.substr(exec_path.find_last_of("\\") + 1, exec_path.size());
+auto ArgumentParser::build(std::size_t count) -> ArgumentBuilder
+{
+	return ArgumentBuilder(*this, count);
+}
+
+void ArgumentParser::update(const std::function<void(ArgumentParser &)> &changes)
+{
+	RegistryLock lock(*this);
+	changes(*this);
+}
+
+auto ArgumentParser::remove(ArgumentHandle handle) -> bool
+{
+	RegistryLock lock(*this);
+	auto pos = args.find(handle);
+	if(pos == ArgumentStore::npos)
+		return false;
 
-	auto &help_arg = args.front();
-	help_arg.example = exec_name + " " + help_arg.command;
+	removeAt(pos);
+	finishRemoval();
+
+	return true;
 }
 
-void ArgumentParser::parseAndRun(std::string cmdline)
+void ArgumentParser::remove(std::string matching_str)
 {
-	std::vector<std::string> commands;
-	std::copy(std::istream_iterator<std::string>(std::stringstream(cmdline)), std::istream_iterator<std::string>(), std::back_inserter(commands));
+	RegistryLock lock(*this);
 
-	bool found_cmd = false;
-	for(auto iter = commands.begin(); iter != commands.end(); iter++)
+	// The index always points at the first argument left with this spelling
+	bool found = false;
+	for(auto pos = index.find(matching_str); pos != ArgumentIndex::npos; pos = index.find(matching_str))
 	{
-		if(found_cmd && *iter == "&&")
-			found_cmd = false;
-		else if(found_cmd)
-			throw ArgumentException(ArgumentException::TOO_MANY_ARGS_ERROR, "There were too many arguments specified");
+		removeAt(pos);
+		found = true;
+	}
 
-		auto found_iter = std::find_if(args.begin(), args.end(), [&](Argument &current_arg)
+	if(found)
+		finishRemoval();
+	else
+	{
+		// Descriptions and examples are not indexed
+		removeIf([&](const ArgumentView &arg) -> bool
 		{
-			if(current_arg.command == *iter)
-				return true;
-			else if(current_arg.long_arg == *iter)
-				return true;
-			else if(current_arg.short_arg == *iter)
-				return true;
-			else
-				return false;
+			return compareArgs(arg, matching_str);
 		});
+	}
+}
 
-		if(found_iter != args.end())
-		{
-			std::string user_data;
-			if(found_iter->flags.isUserDataAllowed() && (iter + 1) != commands.end())
-			{
-				if(!compareArgs(*found_iter, *++iter))
-					user_data = *iter;
-				else
-					throw ArgumentException(ArgumentException::TOO_MANY_ARGS_ERROR, "There were too many arguments specified");
-			}
+void ArgumentParser::remove(Argument &arg)
+{
+	RegistryLock lock(*this);
+	for(auto iter = findArgument(arg); iter != args.end(); iter = findArgument(arg))
+		removeAt(iter.position());
 
-			found_cmd = true;
-			found_iter->func(user_data);
-		}
-	}
+	finishRemoval();
 }
 
-void ArgumentParser::help() const noexcept
+void ArgumentParser::remove(std::vector<Argument> &args_v)
 {
-	std::future<std::string> cmdline_str = std::async([this]()
+	RegistryLock lock(*this);
+
+	// Each one is looked up instead of comparing every pair
+	for(auto &arg : args_v)
 	{
-		std::stringstream cmdline;
-		cmdline << exec_name << " ";
-		for(auto &arg : args)
-		{
-			if(!arg.flags.isLoopOnly())
-			{
-				if(arg.flags.hasShortArg())
-					cmdline << "[" << arg.short_arg;
+		for(auto iter = findArgument(arg); iter != args.end(); iter = findArgument(arg))
+			removeAt(iter.position());
+	}
 
-				if(arg.flags.hasLongArg())
-					cmdline << (arg.flags.hasShortArg() ? '|' : '[') << arg.long_arg << ((arg.flags.isUserDataAllowed()) ? "=" : "");
+	finishRemoval();
+}
 
-				if(arg.flags.hasCommand())
-					cmdline << (arg.flags.hasLongArg() ? '|' : '[') << arg.command;
+auto ArgumentParser::getArgument(std::string match_str) const -> ArgumentView
+{
+	return tryGetArgument(match_str).value();
+}
 
-				if(!arg.data_info.empty())
-					cmdline << " <" << arg.data_info << ">";
+auto ArgumentParser::getArgument(ArgumentHandle handle) const -> ArgumentView
+{
+	return tryGetArgument(handle).value();
+}
 
-				cmdline << "] ";
-			}
-		}
+auto ArgumentParser::tryGetArgument(StringRef match_str) const -> ArgumentResult<ArgumentView>
+{
+	// Not on a snapshot: the view points into the parser's own store, which
+	// outlives the snapshots, so the lookup waits for changes instead
+	RegistryLock lock(*this);
+	auto pos = index.find(match_str);
+	if(pos == ArgumentIndex::npos)
+		return notFound(match_str);
+
+	return args[pos];
+}
 
-		return cmdline.str();
+auto ArgumentParser::tryGetArgument(ArgumentHandle handle) const -> ArgumentResult<ArgumentView>
+{
+	RegistryLock lock(*this);
+	auto pos = args.find(handle);
+	if(pos == ArgumentStore::npos)
+		return ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, "The argument of this handle has been removed");
+
+	return args[pos];
+}
+
+auto ArgumentParser::isRegistered(ArgumentHandle handle) const noexcept -> bool
+{
+	RegistryLock lock(*this);
+	return args.find(handle) != ArgumentStore::npos;
+}
+
+auto ArgumentParser::getUserData(std::string match_str) const -> std::string
+{
+	auto result = findParsed([&](const ArgumentView &arg)
+	{
+		return hasSpelling(arg, match_str);
+	});
+
+	return std::get<1>(result.value());
+}
+
+auto ArgumentParser::getValue(std::string match_str) const -> ArgumentValue
+{
+	auto result = findParsed([&](const ArgumentView &arg)
+	{
+		return hasSpelling(arg, match_str);
 	});
 
-	std::future<std::string> req_info_str = std::async([this]()
+	return std::get<2>(result.value());
+}
+
+auto ArgumentParser::getValues(std::string match_str) const -> ArgumentValues
+{
+	auto result = findParsed([&](const ArgumentView &arg)
+	{
+		return hasSpelling(arg, match_str);
+	});
+
+	// The values stay where the parse put them until the next one
+	auto &parsed_arg = result.value();
+	std::lock_guard<std::mutex> lock(parse_mutex);
+	return (std::get<4>(parsed_arg) != 0) ? ArgumentValues(parse_results.values.data() + std::get<3>(parsed_arg), std::get<4>(parsed_arg)) : ArgumentValues();
+}
+
+auto ArgumentParser::addVariadic(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, ArgumentArity arity, ArgumentValuesFunc func) noexcept -> ArgumentHandle
+{
+	Argument arg;
+	arg.short_arg = s_arg.str();
+	arg.long_arg = l_arg.str();
+	arg.command = cmd.str();
+	arg.data_info = "value...";
+	arg.description = desc.str();
+	arg.example = ex.str();
+	arg.flags = flags;
+	arg.flags |= ArgumentFlags::VARIADIC | (arity.min() != 0 ? ArgumentFlags::USER_DATA_REQUIRED : ArgumentFlags::USER_DATA_ALLOWED);
+	arg.arity = arity;
+	arg.values_func = std::move(func);
+
+	return add(std::move(arg));
+}
+
+auto ArgumentParser::addStream(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, ArgumentStreamFunc func) noexcept -> ArgumentHandle
+{
+	Argument arg;
+	arg.short_arg = s_arg.str();
+	arg.long_arg = l_arg.str();
+	arg.command = cmd.str();
+	arg.description = desc.str();
+	arg.example = ex.str();
+	arg.flags = flags;
+	arg.flags &= ~static_cast<unsigned int>(ArgumentFlags::VARIADIC);
+	arg.flags |= ArgumentFlags::STREAM;
+	arg.stream_func = std::move(func);
+
+	return add(std::move(arg));
+}
+
+auto ArgumentParser::addChoice(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, std::vector<std::string> choices, std::function<void(std::size_t)> func) noexcept -> ArgumentHandle
+{
+	Argument arg;
+	arg.short_arg = s_arg.str();
+	arg.long_arg = l_arg.str();
+	arg.command = cmd.str();
+	arg.description = desc.str();
+	arg.example = ex.str();
+	arg.flags = flags;
+	arg.value_type = ArgumentValue::ENUM;
+	arg.choices = std::move(choices);
+
+	RegistryLock lock(*this);
+
+	std::vector<StringRef> names(arg.choices.begin(), arg.choices.end());
+	arg.data_info = typeName(arg.value_type, names.data(), names.size());
+	arg.value_func = [func](const ArgumentValue &value)
+	{
+		func(value.asEnum());
+	};
+
+	if(!allowsUserData(arg.flags))
+		arg.flags |= ArgumentFlags::USER_DATA_REQUIRED;
+
+	return pushArgument(std::move(arg));
+}
+
+auto ArgumentParser::addGroup(StringRef name, StringRef desc, std::function<void(ArgumentParser &)> factory) noexcept -> ArgumentHandle
+{
+	Argument arg;
+	arg.command = name.str();
+	arg.data_info = "command";
+	arg.description = desc.str();
+	arg.flags = ArgumentFlags::OPTIONAL | ArgumentFlags::USER_DATA_ALLOWED | ArgumentFlags::GROUP;
+
+	// Dispatch hands the rest of the command to the group, there is no function
+	RegistryLock lock(*this);
+	auto handle = pushArgument(std::move(arg));
+	groups.push_back(CommandGroup{ handle, std::move(factory), nullptr });
+
+	return handle;
+}
+
+auto ArgumentParser::getGroup(StringRef name) -> ArgumentParser &
+{
+	RegistryLock lock(*this);
+	auto iter = findArgument(name);
+	if(iter == args.end() || !iter->flags().isGroup())
+		throw notFound(name);
+
+	return group(iter->handle());
+}
+
+auto ArgumentParser::getUserData(Argument &arg) const -> std::string
+{
+	auto result = findParsed([&](const ArgumentView &view)
 	{
-		std::stringstream info;
-		info << "    Required:\n";
+		return compareArgs(view, arg);
+	});
+
+	return std::get<1>(result.value());
+}
 
-		for(auto &arg : args)
+auto ArgumentParser::findParsed(const std::function<bool(const ArgumentView &)> &matches) const -> ArgumentResult<ParsedArgument>
+{
+	auto find = [&](const ArgumentParser &registry) -> ArgumentResult<ParsedArgument>
+	{
+		std::lock_guard<std::mutex> lock(parse_mutex);
+		for(auto &result : parse_results.parsed)
 		{
-			if(!arg.flags.isOptional())
-			{
-				if(arg.flags.hasShortArg())
-					info << "      " << arg.short_arg;
+			// Arguments removed since the parse have no data anymore
+			auto pos = registry.args.find(std::get<0>(result));
+			if(pos != ArgumentStore::npos && matches(registry.args[pos]))
+				return result;
+		}
+
+		return ArgumentException(ArgumentException::NO_USER_DATA_ERROR, "The user has no data supplied");
+	};
+
+	// Looked up like a line would, without waiting for changes
+	if(concurrency)
+	{
+		SnapshotDomain::Guard guard(*concurrency->snapshot.domain());
+		return find(current());
+	}
 
-				if(arg.flags.hasLongArg())
-					info << (arg.flags.hasShortArg() ? ", " : "      ") << arg.long_arg << ((arg.flags.isUserDataAllowed()) ? "=" : "");
+	return find(*this);
+}
 
-				if(arg.flags.hasCommand())
-					info << (arg.flags.hasLongArg() ? ", " : "      ") << arg.command;
+void ArgumentParser::setAlias(std::string existing_arg, Argument &alias)
+{
+	RegistryLock lock(*this);
+	auto iter = findArgument(existing_arg);
 
-				if(!arg.data_info.empty())
-					info << " <" << arg.data_info << "> ";
+	if(iter == args.end())
+		throw ArgumentException(ArgumentException::ALIAS_ERROR, "The argument " + existing_arg + " does not exist");
 
-				if(!arg.description.empty())
-				{
-					info << std::setw(45) << arg.description << std::endl;
-				}
+	alias.flags = iter->flags();
+	normalizeFlags(alias);
 
-				info << std::endl;
-			}
+	auto existing = iter->toArgument();
+	alias.func = existing.func;
+	alias.value_type = existing.value_type;
+	alias.choices = existing.choices;
+	alias.value_func = existing.value_func;
+	alias.arity = existing.arity;
+	alias.values_func = existing.values_func;
+	alias.stream_func = existing.stream_func;
+	alias.example = existing.example;
+	alias.data_info = existing.data_info;
+
+	if(alias.description.empty())
+		alias.description = "This is an alias for " + primarySpelling(*iter);
+
+	if(alias.long_description.empty())
+	{
+		auto arg_descript = primarySpelling(*iter);
+		alias.long_description = "This is an alias for " + arg_descript + ". See the help for " + arg_descript + " for more information.";
+	}
+
+	pushArgument(alias);
+}
+
+void ArgumentParser::setAlias(Argument &existing_arg, Argument &alias)
+{
+	RegistryLock lock(*this);
+
+	alias.flags = existing_arg.flags;
+	normalizeFlags(alias);
+
+	auto iter = findArgument(existing_arg);
+	if(iter == args.end())
+		throw ArgumentException(ArgumentException::ALIAS_ERROR, "The specified argument does not exist");
+
+	auto existing = iter->toArgument();
+	alias.func = existing.func;
+	alias.value_type = existing.value_type;
+	alias.choices = existing.choices;
+	alias.value_func = existing.value_func;
+	alias.arity = existing.arity;
+	alias.values_func = existing.values_func;
+	alias.stream_func = existing.stream_func;
+	alias.example = existing.example;
+	alias.data_info = existing.data_info;
+
+	if(alias.description.empty())
+		alias.description = "This is an alias for " + primarySpelling(*iter);
+
+	if(alias.long_description.empty())
+	{
+		auto arg_descript = primarySpelling(*iter);
+		alias.long_description = "This is an alias for " + arg_descript + ". See the help for " + arg_descript + " for more information.";
+	}
+
+	pushArgument(alias);
+}
+
+void ArgumentParser::parse(int argc, char **argv, bool execute_funcs)
+{
+	auto result = tryParse(argc, argv, execute_funcs);
+	if(!result)
+		result.rethrow();
+}
+
+auto ArgumentParser::tryParse(int argc, char **argv, bool execute_funcs) -> ArgumentResult<void>
+{
+	// Unknown or invalid arguments are returned, only unreadable response
+	// files and the functions themselves throw
+	try
+	{
+		ArgvReader reader(argc - 1, argv + 1, response_depth);
+		return tryParse(reader, argv[0], execute_funcs);
+	}
+	catch(const ArgumentException &e)
+	{
+		return ArgumentResult<void>(e, std::current_exception());
+	}
+}
+
+auto ArgumentParser::tryParse(ArgvReader &reader, StringRef name, bool execute_funcs) -> ArgumentResult<void>
+{
+	{
+		RegistryLock lock(*this);
+		saveExecName(name.str());
+	}
+
+	// Only the results of the latest parse are kept, with the files they point into
+	ParseResults results;
+	results.response_files = reader.files();
+
+	ArgumentResult<void> result;
+	try
+	{
+		// Like a line, a concurrent parser parses on a snapshot and changes need not wait
+		if(concurrency)
+		{
+			SnapshotDomain::Guard guard(*concurrency->snapshot.domain());
+			result = current().parseInto(reader, execute_funcs, results);
 		}
+		else
+			result = parseInto(reader, execute_funcs, results);
+	}
+	catch(...)
+	{
+		// What was parsed before a function threw is kept as well
+		std::lock_guard<std::mutex> lock(parse_mutex);
+		parse_results = std::move(results);
+		throw;
+	}
 
-		return info.str();
-	});
+	std::lock_guard<std::mutex> lock(parse_mutex);
+	parse_results = std::move(results);
+	return result;
+}
 
-	std::future<std::string> opt_info_str = std::async([this]()
+auto ArgumentParser::parseInto(ArgvReader &reader, bool execute_funcs, ParseResults &results) -> ArgumentResult<void>
+{
+	bool options_ended = false;
+	StringRef token;
+	while(reader.next(token))
 	{
-		std::stringstream info;
-		info << "    Optional:\n";
+		if(options_ended)
+		{
+			results.positional.push_back(token);
+			continue;
+		}
 
-		for(auto &arg : args)
+		if(token == StringRef("--"))
 		{
-			if(arg.flags.isOptional())
-			{
-				if(arg.flags.hasShortArg())
-					info << "      " << arg.short_arg;
+			options_ended = true;
+			continue;
+		}
+
+		// -o file1, --open file1 or open file1
+		auto iter = findArgvArgument(token);
+		if(iter != args.end() && iter->flags().isGroup())
+		{
+			// The group's name is its argv[0]
+			auto result = group(iter->handle()).tryParse(reader, token, execute_funcs);
+			if(!result)
+				return result;
 
-				if(arg.flags.hasLongArg())
-					info << (arg.flags.hasShortArg() ? ", " : "      ") << arg.long_arg;
+			break;
+		}
+		else if(iter != args.end() && iter->flags().isVariadic())
+		{
+			auto result = runVariadic(iter, token, StringRef(), reader, execute_funcs, results);
+			if(!result)
+				return result;
+
+			continue;
+		}
+		else if(iter != args.end())
+		{
+			auto user_data = takeUserData(*iter, token, reader);
+			if(!user_data)
+				return user_data.error();
 
-				if(arg.flags.hasCommand())
-					info << (arg.flags.hasLongArg() ? ", " : "      ") << arg.command;
+			auto result = runParsed(iter, token, *user_data, execute_funcs, results);
+			if(!result)
+				return result;
 
-				if(!arg.data_info.empty())
-					info << " <" << arg.data_info << "> ";
+			continue;
+		}
 
-				if(!arg.description.empty())
+		if(token.size() > 2 && token[0] == '-' && token[1] == '-')
+		{
+			// --open=file1
+			auto equal_pos = token.find('=');
+			if(equal_pos != std::string::npos)
+			{
+				auto name = token.substr(0, equal_pos);
+				iter = findArgvArgument(name);
+				if(iter != args.end() && iter->flags().isVariadic())
 				{
-					info << std::setw(45) << arg.description << std::endl;
+					// --files=a b c
+					auto result = runVariadic(iter, name, token.substr(equal_pos + 1), reader, execute_funcs, results);
+					if(!result)
+						return result;
+
+					continue;
 				}
+				else if(iter != args.end())
+				{
+					if(!allowsUserData(iter->flags()))
+						return ArgumentException(ArgumentException::TOO_MANY_ARGS_ERROR, "The argument " + name.str() + " does not take user data");
 
-				info << std::endl;
+					auto result = runParsed(iter, name, token.substr(equal_pos + 1), execute_funcs, results);
+					if(!result)
+						return result;
+
+					continue;
+				}
 			}
 		}
+		else if(token.size() > 2 && token[0] == '-')
+		{
+			// -abc or -ofile1
+			auto cluster = parseShortCluster(token, reader, execute_funcs, results);
+			if(!cluster)
+				return cluster.error();
+			else if(*cluster)
+				continue;
+		}
+
+		// Unknown options are typos, --bogus=file1 is named without its value
+		if(looksLikeOption(token) && !looksLikeNegativeNumber(token))
+			return notFound(token.substr(0, token.find('=')));
+
+		results.positional.push_back(token);
+	}
+
+	if(config)
+		return applyConfig(execute_funcs, results);
+
+	return ArgumentResult<void>();
+}
+
+auto ArgumentParser::getPositional() const -> std::vector<StringRef>
+{
+	std::lock_guard<std::mutex> lock(parse_mutex);
+	return parse_results.positional;
+}
+
+void ArgumentParser::setResponseFileDepth(std::size_t depth) noexcept
+{
+	response_depth = depth;
+}
+
+auto ArgumentParser::getConfig() -> ConfigLayers &
+{
+	RegistryLock lock(*this);
+	if(!config)
+	{
+		config = std::make_shared<ConfigLayers>();
+		markChanged();
+	}
+
+	return *config;
+}
+
+auto ArgumentParser::loop(int argc, char **argv, bool catch_except) -> int
+{
+	parse(argc, argv);
 
-		return info.str();
+	std::string output = exec_name;
+	output.append(" > ");
+
+	// Reused for every line so its capacity carries over
+	std::string cmdline;
+
+	line_editor.setCompleter([this](StringRef line, LineEditor::Completion &completion)
+	{
+		completeLine(line, completion);
 	});
 
-	std::future<std::string> examples_str = std::async([this]()
+	// Stop at the end of input instead of prompting forever
+	while(line_editor.readLine(output, cmdline))
+	{
+		// Unknown commands and bad user data come back without unwinding
+		auto result = tryDispatch(cmdline);
+		if(!result && !catch_except)
+			result.rethrow();
+		else if(!result)
+			reportError(result.error());
+	}
+
+	return 0;
+}
+
+auto ArgumentParser::run(std::istream &input, bool catch_except) -> std::size_t
+{
+	// Whole lines are tokenized in place inside the block buffer.
+	// A line longer than the buffer makes it grow.
+	std::vector<char> buffer(script_block_size);
+	std::size_t filled = 0;
+	std::size_t commands = 0;
+
+	bool end = false;
+	while(!end)
 	{
-		std::stringstream examples;
-		examples << "    Examples:\n";
+		if(filled == buffer.size())
+			buffer.resize(buffer.size() * 2);
 
-		for(auto &arg : args)
+		input.read(buffer.data() + filled, buffer.size() - filled);
+		filled += static_cast<std::size_t>(input.gcount());
+		end = !input;
+
+		char *line = buffer.data();
+		char *last = buffer.data() + filled;
+		while(line != last)
 		{
-			if(!arg.example.empty())
-				examples << "      " << arg.example << std::endl;
+			auto newline = static_cast<char *>(std::memchr(line, '\n', last - line));
+			if(newline == nullptr)
+			{
+				// Keep the incomplete line for the next block
+				if(!end)
+					break;
+
+				newline = last;
+			}
+
+			if(runLine(line, newline, catch_except))
+				commands++;
+
+			line = (newline != last) ? newline + 1 : last;
 		}
 
-		return examples.str();
-	});
+		filled = last - line;
+		std::memmove(buffer.data(), line, filled);
+	}
 
-	std::cout << "Help:\n\n" 
-		<< cmdline_str.get() 
-		<< "\n\n" 
-		<< req_info_str.get()
-		<< opt_info_str.get()
-		<< examples_str.get();
-}
-
-void ArgumentParser::help(std::string arg_help) const noexcept
-{
-	std::future<std::string> help_str = std::async([this, &arg_help]()
-	{
-		std::stringstream help;
-		auto arg = getArgument(arg_help);
-
-		help << "Extended help:\n\n"
-			<< "    Arguments/Command:\n";
-		
-		if(arg.flags.hasShortArg())
-			help << "      Short argument: " << arg.short_arg << (!arg.data_info.empty() ? (" <" + arg.data_info + ">\n") : "\n");
-			
-		if(arg.flags.hasLongArg())
-			help << "      Long argument: " << arg.long_arg << (!arg.data_info.empty() ? ("=<" + arg.data_info + ">\n") : "\n");
-			
-		if(arg.flags.hasCommand())
-			help << "      Command: " << arg.command << (!arg.data_info.empty() ? (" <" + arg.data_info + ">\n") : "\n");
-		
-		help << std::endl
-			<< "    Full description:\n";
-		if(!arg.long_description.empty())
-			help << "      " << arg.long_description << std::endl;
-		else if(!arg.description.empty())
-			help << "      " << arg.description << std::endl;
-
-		help << std::endl
-			<< "    Flags:\n"
-			<< "      Has short arg: " << (arg.flags.hasShortArg() ? "true" : "false") << std::endl
-			<< "      Has long arg: " << (arg.flags.hasLongArg() ? "true" : "false") << std::endl
-			<< "      Has command: " << (arg.flags.hasCommand() ? "true" : "false") << std::endl
-			<< "      Is optional: " << (arg.flags.isOptional() ? "true" : "false") << std::endl
-			<< "      Is loop only: " << (arg.flags.isLoopOnly() ? "true" : "false") << std::endl
-			<< "      Is user data allowed: " << (arg.flags.isUserDataAllowed() ? "true" : "false") << std::endl
-			<< "      Is user data required: " << (arg.flags.isUserDataRequired() ? "true" : "false") << std::endl
-			<< std::endl;	
-
-		return help.str();
-	});
+	return commands;
+}
+
+auto ArgumentParser::runScript(const std::string &path, bool catch_except) -> std::size_t
+{
+	std::ifstream script(path, std::ios::binary);
+	if(!script)
+		throw ArgumentException(ArgumentException::IO_ERROR, "The script " + path + " could not be opened");
 
-	std::cout << help_str.get();
+	return run(script, catch_except);
 }
 
+void ArgumentParser::complete(StringRef prefix, LineEditor::Completion &completion, std::size_t limit) const
+{
+	if(concurrency)
+	{
+		SnapshotDomain::Guard guard(*concurrency->snapshot.domain());
+		current().complete(prefix, completion, limit);
+		return;
+	}
+
+	completion.total = trie.complete(prefix, completion.candidates, limit);
+	completion.common = trie.commonPrefix(prefix);
+}
+
+void ArgumentParser::completeLine(StringRef line, LineEditor::Completion &completion, std::size_t limit) const
+{
+	if(concurrency)
+	{
+		SnapshotDomain::Guard guard(*concurrency->snapshot.domain());
+		current().completeLine(line, completion, limit);
+		return;
+	}
+
+	// Only the words after the last & or | belong to the command being typed
+	std::size_t start = line.size();
+	while(start > 0 && line[start - 1] != '&' && line[start - 1] != '|')
+		start--;
+
+	const ArgumentParser *scope = this;
+	std::size_t pos = start;
+	while(true)
+	{
+		while(pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+			pos++;
+
+		std::size_t word_end = pos;
+		while(word_end < line.size() && line[word_end] != ' ' && line[word_end] != '\t')
+			word_end++;
+
+		// The last word is the one being completed
+		if(word_end == line.size())
+			break;
+
+		// Words after the groups are user data, which still completes among
+		// the spellings of the innermost group
+		auto word = line.substr(pos, word_end - pos);
+		auto word_pos = scope->index.find(word);
+		if(word_pos == ArgumentIndex::npos || !scope->args[word_pos].flags().isGroup())
+			break;
+
+		scope = &scope->group(scope->args.handle(word_pos)).current();
+		pos = word_end;
+	}
+
+	// A blank at the end completes all spellings of the scope
+	std::size_t word_start = line.size();
+	while(word_start > start && line[word_start - 1] != ' ' && line[word_start - 1] != '\t')
+		word_start--;
+
+	scope->complete(line.substr(word_start), completion, limit);
+}
+
+auto ArgumentParser::suggest(StringRef spelling, std::size_t limit) const -> std::vector<std::string>
+{
+	if(concurrency)
+	{
+		SnapshotDomain::Guard guard(*concurrency->snapshot.domain());
+		return current().suggest(spelling, limit);
+	}
+
+	// Short words get one edit, anything longer two. Most typos are one edit,
+	// which is much cheaper to search, so two are only tried without a match.
+	const std::size_t max_distance = (spelling.size() <= 4) ? 1 : 2;
+
+	std::vector<ArgumentTrie::Match> matches;
+	for(std::size_t distance = 1; distance <= max_distance && matches.empty(); distance++)
+		trie.similar(spelling, distance, matches);
+
+	std::vector<std::string> suggestions;
+	for(std::size_t pos = 0; pos < matches.size() && suggestions.size() < limit; pos++)
+		suggestions.push_back(std::move(matches[pos].first));
+
+	return suggestions;
+}
+
+auto ArgumentParser::getLineEditor() noexcept -> LineEditor &
+{
+	return line_editor;
+}
+
+void ArgumentParser::setHistoryFile(const std::string &path, std::size_t data_size, std::size_t max_entries)
+{
+	std::unique_ptr<CommandHistory> opened(new CommandHistory(path, data_size, max_entries));
+	line_editor.setHistoryLog(opened.get());
+	history = std::move(opened);
+
+	addHistoryArgs();
+}
+
+auto ArgumentParser::getHistory() noexcept -> CommandHistory *
+{
+	return history.get();
+}
+
+auto ArgumentParser::replay(const CommandHistory &lines, std::uint64_t first, std::uint64_t last, bool catch_except) -> std::size_t
+{
+	if(replaying)
+		return 0;
+
+	struct ReplayScope
+	{
+		ReplayScope() noexcept { replaying = true; }
+		~ReplayScope() { replaying = false; }
+	} scope;
+
+	// A replay started by a command must leave the tokens of its own line
+	// alone, and the lines are tokenized in place, so they are copied
+	CommandTokenizer replay_tokenizer;
+	std::string line;
+	std::size_t commands = 0;
+	for(auto number = std::max(first, lines.first()); number < std::min(last, lines.next()); number++)
+	{
+		auto text = lines.at(number);
+		line.assign(text.data(), text.size());
+
+		if(runLine(replay_tokenizer, &line[0], &line[0] + line.size(), catch_except))
+			commands++;
+	}
+
+	return commands;
+}
+
+auto ArgumentParser::compareArgs(const ArgumentView &arg, std::string &str) const noexcept -> bool
+{
+	if(arg.command() == str)
+		return true;
+	else if(arg.shortArg() == str)
+		return true;
+	else if(arg.longArg() == str)
+		return true;
+	else if(arg.description() == str)
+		return true;
+	else if(arg.example() == str)
+		return true;
+	else 
+		return false;
+}
+
+auto ArgumentParser::compareArgs(const ArgumentView &arg, const Argument &other_arg) const noexcept -> bool
+{
+	if(arg.command() != other_arg.command)
+		return false;
+	else if(arg.shortArg() != other_arg.short_arg)
+		return false;
+	else if(arg.longArg() != other_arg.long_arg)
+		return false;
+	else if(arg.description() != other_arg.description)
+		return false;
+	else if(arg.example() != other_arg.example)
+		return false;
+	else if(arg.flags() != spellingFlags(other_arg.flags, other_arg.short_arg, other_arg.long_arg, other_arg.command))
+		return false;
+	else
+		return true;
+}
+
+auto ArgumentParser::findArgument(StringRef spelling) noexcept -> ArgIter
+{
+	auto pos = index.find(spelling);
+	return (pos != ArgumentIndex::npos) ? args.at(pos) : args.end();
+}
+
+auto ArgumentParser::findArgument(const Argument &arg) noexcept -> ArgIter
+{
+	// Look up by any spelling, then make sure it is really the same argument
+	for(auto spelling : { &arg.command, &arg.long_arg, &arg.short_arg })
+	{
+		auto iter = findArgument(*spelling);
+		if(iter != args.end() && compareArgs(*iter, arg))
+			return iter;
+	}
+
+	return args.end();
+}
+
+auto ArgumentParser::findAbbreviation(StringRef prefix) noexcept -> ArgIter
+{
+	// Only a prefix of exactly one spelling is an abbreviation
+	std::string spelling;
+	return (!prefix.empty() && trie.unique(prefix, spelling)) ? findArgument(spelling) : args.end();
+}
+
+auto ArgumentParser::findArgvArgument(StringRef spelling) noexcept -> ArgIter
+{
+	auto iter = findArgument(spelling);
+	return (iter != args.end() && !iter->flags().isLoopOnly()) ? iter : args.end();
+}
+
+auto ArgumentParser::parseShortCluster(StringRef token, ArgvReader &reader, bool execute_funcs, ParseResults &results) -> ArgumentResult<bool>
+{
+	char short_arg[2] = { '-', '\0' };
+
+	for(std::size_t pos = 1; pos < token.size(); pos++)
+	{
+		short_arg[1] = token[pos];
+		auto iter = findArgvArgument(StringRef(short_arg, 2));
+		if(iter == args.end())
+		{
+			// Not a cluster at all, so leave the token alone
+			if(pos == 1)
+				return false;
+
+			return ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, "The argument " + std::string(short_arg, 2) + " in " + token.str() + " could not be found");
+		}
+
+		if(iter->flags().isVariadic())
+		{
+			// -fa b c, the rest of the token is the first value
+			auto result = runVariadic(iter, StringRef(short_arg, 2), token.substr(pos + 1), reader, execute_funcs, results);
+			if(!result)
+				return result.error();
+
+			return true;
+		}
+
+		if(allowsUserData(iter->flags()))
+		{
+			// The rest of the token is the user data, otherwise look at the next one
+			auto rest = token.substr(pos + 1);
+			auto user_data = rest.empty() ? takeUserData(*iter, StringRef(short_arg, 2), reader) : ArgumentResult<StringRef>(rest);
+			if(!user_data)
+				return user_data.error();
+
+			auto result = runParsed(iter, StringRef(short_arg, 2), *user_data, execute_funcs, results);
+			if(!result)
+				return result.error();
+
+			return true;
+		}
+
+		auto result = runParsed(iter, StringRef(short_arg, 2), StringRef(), execute_funcs, results);
+		if(!result)
+			return result.error();
+	}
+
+	return true;
+}
+
+auto ArgumentParser::takeUserData(const ArgumentView &arg, StringRef token, ArgvReader &reader) -> ArgumentResult<StringRef>
+{
+	if(!allowsUserData(arg.flags()))
+		return StringRef();
+
+	// Optional user data must not look like another argument
+	StringRef next;
+	if(reader.peek(next) && (arg.flags().isUserDataRequired() || (!looksLikeOption(next) && findArgument(next) == args.end())))
+	{
+		reader.next(next);
+		return next;
+	}
+
+	if(arg.flags().isUserDataRequired())
+		return ArgumentException(ArgumentException::NO_USER_DATA_ERROR, "The argument " + token.str() + " requires user data");
+
+	return StringRef();
+}
+
+auto ArgumentParser::runParsed(ArgIter iter, StringRef spelling, StringRef user_data, bool execute_funcs, ParseResults &results) -> ArgumentResult<void>
+{
+	// The value refers to argv, which outlives the parse results
+	auto value = toValue(*iter, spelling, user_data);
+	if(!value)
+		return value.error();
+
+	if(execute_funcs)
+		call(iter, user_data, *value, ArgumentValues());
+
+	results.parsed.push_back(ParsedArgument(iter->handle(), user_data.str(), *value, 0, 0));
+	return ArgumentResult<void>();
+}
+
+auto ArgumentParser::runVariadic(ArgIter iter, StringRef spelling, StringRef first_value, ArgvReader &reader, bool execute_funcs, ParseResults &results) -> ArgumentResult<void>
+{
+	// All values of a parse go into one buffer, the call gets its slice
+	auto arity = iter->arity();
+	auto first = results.values.size();
+	if(!first_value.empty())
+		results.values.push_back(first_value);
+
+	StringRef next;
+	while(results.values.size() - first < arity.max() && reader.peek(next))
+	{
+		if(results.values.size() - first >= arity.min() && endsValues(next))
+			break;
+
+		reader.next(next);
+		results.values.push_back(next);
+	}
+
+	auto count = results.values.size() - first;
+	if(count < arity.min())
+		return missingValues(spelling, arity);
+
+	if(execute_funcs)
+		call(iter, StringRef(), ArgumentValue(), ArgumentValues(results.values.data() + first, count));
+
+	results.parsed.push_back(ParsedArgument(iter->handle(), std::string(), ArgumentValue(), first, count));
+	return ArgumentResult<void>();
+}
+
+auto ArgumentParser::applyConfig(bool execute_funcs, ParseResults &results) -> ArgumentResult<void>
+{
+	// The command line wins over the other layers
+	std::vector<bool> given(args.slotCount());
+	for(auto &result : results.parsed)
+	{
+		auto pos = args.find(std::get<0>(result));
+		if(pos != ArgumentStore::npos)
+			given[args.slot(pos)] = true;
+	}
+
+	results.config_table = config->table();
+	StringRef value;
+	for(auto iter = args.begin(); iter != args.end(); iter++)
+	{
+		auto flags = iter->flags();
+		if(flags.isLoopOnly() || flags.isGroup() || flags.isVariadic() || given[args.slot(iter.position())])
+			continue;
+
+		auto key = configKey(*iter);
+		if(key.empty() || !config->find(*results.config_table, key, value))
+			continue;
+
+		ArgumentResult<void> result;
+		if(allowsUserData(flags))
+			result = runParsed(iter, key, value, execute_funcs, results);
+		else if(isTrue(value))
+			result = runParsed(iter, key, StringRef(), execute_funcs, results);
+
+		if(!result)
+			return result;
+	}
+
+	return ArgumentResult<void>();
+}
+
+auto ArgumentParser::findConfig(const ArgumentView &arg, LineData &line, StringRef &value) -> bool
+{
+	auto key = configKey(arg);
+	if(key.empty())
+		return false;
+
+	// The file is looked at once per line
+	if(!line.config)
+		line.config = config->table();
+
+	return config->find(*line.config, key, value);
+}
+
+auto ArgumentParser::endsValues(StringRef token) noexcept -> bool
+{
+	// Values beyond the minimum stop at the next option or argument
+	return looksLikeOption(token) || findArgument(token) != args.end();
+}
+
+void ArgumentParser::call(ArgIter iter, StringRef user_data, const ArgumentValue &value, ArgumentValues values, CommandStream *stream)
+{
+	RunningScope scope(running);
+
+	// Without stats this check is all a call costs
+	if(!stats)
+	{
+		invoke(*iter, user_data, value, values, stream);
+		return;
+	}
+
+	auto start = CommandStats::Clock::now();
+	try
+	{
+		invoke(*iter, user_data, value, values, stream);
+	}
+	catch(const ArgumentException &e)
+	{
+		stats->recordError(args.slot(iter.position()), CommandStats::Clock::now() - start, e.code());
+		throw;
+	}
+	catch(...)
+	{
+		stats->recordError(args.slot(iter.position()), CommandStats::Clock::now() - start, ArgumentException::UNKNOWN);
+		throw;
+	}
+
+	stats->record(args.slot(iter.position()), CommandStats::Clock::now() - start);
+}
+
+void ArgumentParser::call(const PendingCommand &command)
+{
+	// An earlier command of the same line may have removed this one
+	auto &scope = *command.parser;
+	auto pos = scope.args.find(command.arg);
+	if(pos == ArgumentStore::npos)
+		throw ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, "The argument " + command.spelling.str() + " has been removed");
+
+	scope.call(scope.args.at(pos), command.user_data, command.value, command.values);
+}
+
+void ArgumentParser::call(const PendingCommand &command, CommandChannel *input, CommandChannel *output)
+{
+	auto &scope = *command.parser;
+	auto pos = scope.args.find(command.arg);
+	if(pos == ArgumentStore::npos)
+		throw ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, "The argument " + command.spelling.str() + " has been removed");
+
+	auto iter = scope.args.at(pos);
+	if(iter->flags().isStream())
+	{
+		CommandStream stream(command.user_data, input, output);
+		scope.call(iter, command.user_data, ArgumentValue(), ArgumentValues(), &stream);
+		return;
+	}
+
+	// Any other command ends a pipeline and is called once per line, with the
+	// line as its user data
+	std::string line;
+	while(input->read(line))
+	{
+		StringRef user_data(line);
+		auto value = toValue(*iter, command.spelling, user_data);
+		if(!value)
+			value.rethrow();
+
+		scope.call(iter, user_data, *value, iter->flags().isVariadic() ? ArgumentValues(&user_data, 1) : ArgumentValues());
+	}
+}
+
+auto ArgumentParser::group(ArgumentHandle handle) const -> ArgumentParser &
+{
+	if(origin)
+	{
+		// Snapshots never change, the parser they were taken from creates the group
+		for(auto &entry : groups)
+		{
+			if(entry.handle == handle && entry.parser)
+				return *entry.parser;
+		}
+
+		return origin->group(handle);
+	}
+
+	RegistryLock lock(*this);
+
+	// A snapshot may still show a group removed since
+	auto pos = args.find(handle);
+	if(pos == ArgumentStore::npos)
+		throw ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, "The command group has been removed");
+
+	auto iter = std::find_if(groups.begin(), groups.end(), [&](const CommandGroup &group)
+	{
+		return group.handle == handle;
+	});
+
+	if(iter == groups.end())
+		throw ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, "The argument " + primarySpelling(args[pos]) + " is no command group");
+
+	if(!iter->parser)
+	{
+		// Only kept once the factory returned, a factory that throws runs again next time
+		std::shared_ptr<ArgumentParser> parser(new ArgumentParser(exec_name + " " + args[pos].command().str(), Scope::GROUP));
+		if(stats)
+			parser->setStatsEnabled(true);
+
+		auto factory = iter->factory;
+		factory(*parser);
+
+		if(concurrency)
+			parser->setSnapshotDomain(concurrency->snapshot.domain());
+
+		iter->parser = std::move(parser);
+		iter->factory = nullptr;
+
+		// Later snapshots share the group
+		markChanged();
+	}
+
+	return *iter->parser;
+}
+
+void ArgumentParser::pruneGroups()
+{
+	groups.erase(std::remove_if(groups.begin(), groups.end(), [&](const CommandGroup &group)
+	{
+		return !isRegistered(group.handle);
+	}), groups.end());
+}
+
+void ArgumentParser::setSnapshotDomain(std::shared_ptr<SnapshotDomain> domain)
+{
+	// Groups created later get the domain when they are created
+	for(auto &group : groups)
+	{
+		if(group.parser)
+			group.parser->setSnapshotDomain(domain);
+	}
+
+	concurrency.reset(domain ? new Concurrency(std::move(domain)) : nullptr);
+	if(concurrency)
+		publish();
+}
+
+void ArgumentParser::markChanged() const noexcept
+{
+	if(concurrency)
+		concurrency->changed = true;
+}
+
+void ArgumentParser::publish() const
+{
+	concurrency->snapshot.publish(std::unique_ptr<ArgumentParser>(new ArgumentParser(*this, Scope::SNAPSHOT)));
+	concurrency->changed = false;
+}
+
+auto ArgumentParser::lockRegistry() const -> bool
+{
+	if(!concurrency)
+		return false;
+
+	concurrency->mutex.lock();
+	concurrency->depth++;
+
+	return true;
+}
+
+void ArgumentParser::unlockRegistry() const
+{
+	if(--concurrency->depth == 0 && concurrency->changed)
+		publish();
+
+	concurrency->mutex.unlock();
+}
+
+auto ArgumentParser::current() const noexcept -> ArgumentParser &
+{
+	return concurrency ? *concurrency->snapshot.load() : const_cast<ArgumentParser &>(*this);
+}
+
+auto ArgumentParser::lineTokenizer() noexcept -> CommandTokenizer &
+{
+	return concurrency ? thread_tokenizer : tokenizer;
+}
+
+auto ArgumentParser::pushArgument(const Argument &arg) -> ArgumentHandle
+{
+	auto handle = args.add(arg);
+	registerLast();
+
+	return handle;
+}
+
+auto ArgumentParser::pushArgument(Argument &&arg) -> ArgumentHandle
+{
+	auto handle = args.add(std::move(arg));
+	registerLast();
+
+	return handle;
+}
+
+void ArgumentParser::registerLast()
+{
+	const std::size_t pos = args.recordCount() - 1;
+
+	// Only the new argument is normalized, the rest already is
+	auto arg = args[pos];
+	args.setFlags(pos, spellingFlags(arg.flags(), arg.shortArg(), arg.longArg(), arg.command()));
+
+	index.insert(arg, pos);
+	insertSpellings(trie, arg);
+	help_cache.append(arg);
+	markChanged();
+
+	// The slot may have belonged to a removed argument
+	if(stats)
+	{
+		stats->resize(args.slotCount());
+		stats->reset(args.slot(pos));
+	}
+}
+
+void ArgumentParser::removeIf(const std::function<bool(const ArgumentView &)> &pred)
+{
+	for(auto arg : args)
+	{
+		if(pred(arg))
+			removeAt(arg.position());
+	}
+
+	finishRemoval();
+}
+
+void ArgumentParser::removeAt(std::size_t pos)
+{
+	// The texts stay in the pool until the store compacts
+	auto arg = args[pos];
+	args.erase(arg.handle());
+
+	for(auto spelling : { arg.shortArg(), arg.longArg(), arg.command() })
+	{
+		trie.erase(spelling);
+
+		// Another argument with the same spelling takes over, the first one
+		// like a rebuilt index would pick
+		if(index.erase(spelling, pos) && trie.contains(spelling))
+		{
+			for(auto other : args)
+			{
+				if(other.shortArg() == spelling || other.longArg() == spelling || other.command() == spelling)
+				{
+					index.insert(spelling, other.position());
+					break;
+				}
+			}
+		}
+	}
+}
+
+void ArgumentParser::finishRemoval()
+{
+	help_cache.invalidate();
+	markChanged();
+
+	// Functions of removed arguments may still run, e.g. a command that
+	// removes itself, so only compact while nothing is called
+	if(running.load() != 0)
+		return;
+
+	pruneGroups();
+	if(!args.needsCompaction())
+		return;
+
+	// Positions have changed, handles and the slots of the stats have not
+	args.compact();
+	index.rebuild(args);
+}
+
+void ArgumentParser::addBaseArgs(std::string &&prog_name) noexcept
+{
+	exec_path = prog_name;
+	exec_name = exec_path.substr(exec_path.find_last_of("\\") + 1, exec_path.size());
+
+	addHelpArg();
+
+	Argument exit_arg;
+	exit_arg.command = "exit";
+	exit_arg.description = "Exits this application";
+	exit_arg.data_info = "exit_code";
+	exit_arg.example = exec_name + " > exit";
+	exit_arg.flags |= (ArgumentFlags::COMMAND |
+		ArgumentFlags::OPTIONAL |
+		ArgumentFlags::USER_DATA_ALLOWED);
+	exit_arg.value_type = ArgumentValueTraits<int>::type;
+	exit_arg.value_func = [&](const ArgumentValue &value)
+	{
+		int exit_code = static_cast<int>(value.asInt());
+
+		auto hook = ExitHook::current();
+		if(hook != nullptr)
+			(*hook)(exit_code);
+		else
+			exit(exit_code);
+	};
+	pushArgument(exit_arg);
+
+	Argument close_alias;
+	close_alias.command = "close";
+	close_alias.example = exec_name + " > close";
+	setAlias(exit_arg, close_alias);
+
+	Argument stats_arg;
+	stats_arg.command = "stats";
+	stats_arg.data_info = "on|off|reset|command";
+	stats_arg.description = "Shows call counts and latencies of the commands";
+	stats_arg.example = exec_name + " > stats on";
+	stats_arg.flags |= (ArgumentFlags::COMMAND |
+		ArgumentFlags::OPTIONAL |
+		ArgumentFlags::LOOP_ONLY |
+		ArgumentFlags::USER_DATA_ALLOWED);
+	stats_arg.func = [&](StringRef string)
+	{
+		if(string == "on")
+			setStatsEnabled(true);
+		else if(string == "off")
+			setStatsEnabled(false);
+		else if(string == "reset")
+			resetStats();
+		else
+			printStats(string.str());
+	};
+	pushArgument(std::move(stats_arg));
+}
+
+void ArgumentParser::addHelpArg() noexcept
+{
+	Argument help_arg;
+	help_arg.short_arg = "-h";
+	help_arg.long_arg = "--help";
+	help_arg.command = "help";
+	help_arg.data_info = "command";
+	help_arg.description = "Shows information for registered commands";
+	help_arg.example = exec_name + " help";
+	help_arg.flags |= (ArgumentFlags::SHORT_ARG | 
+		ArgumentFlags::LONG_ARG |
+		ArgumentFlags::COMMAND	| 
+		ArgumentFlags::OPTIONAL | 
+		ArgumentFlags::USER_DATA_ALLOWED);
+	help_arg.func = [&](StringRef string)
+	{
+		if(string.empty())
+			help();
+		else
+			help(string.str());
+	};
+	help_handle = pushArgument(std::move(help_arg));
+}
+
+void ArgumentParser::saveExecName(std::string name) noexcept
+{
+	if(exec_path.empty())
+		exec_path = name;
+
+	if(exec_name.empty())
+		exec_name = exec_path.substr(exec_path.find_last_of("\\") + 1, exec_path.size());
+
+	// The built-in help may have been removed
+	auto pos = args.find(help_handle);
+	if(pos == ArgumentStore::npos)
+		return;
+
+	auto help_arg = args[pos];
+	auto example = exec_name + " " + help_arg.command().str();
+	if(help_arg.example() != example)
+	{
+		args.setExample(pos, example);
+		help_cache.invalidate();
+		markChanged();
+	}
+}
+
+auto ArgumentParser::tryDispatch(std::string &line) -> ArgumentResult<void>
+{
+	auto &line_tokenizer = lineTokenizer();
+	auto tokens = line_tokenizer.tryTokenize(&line[0], &line[0] + line.size());
+	if(!tokens)
+		return tokens;
+
+	return tryDispatch(line_tokenizer.tokens());
+}
+
+auto ArgumentParser::runLine(char *first, char *last, bool catch_except) -> bool
+{
+	return runLine(lineTokenizer(), first, last, catch_except);
+}
+
+auto ArgumentParser::runLine(CommandTokenizer &line_tokenizer, char *first, char *last, bool catch_except) -> bool
+{
+	auto result = line_tokenizer.tryTokenize(first, last);
+	if(result)
+	{
+		// Empty lines and comments are no commands
+		auto &tokens = line_tokenizer.tokens();
+		if(tokens.empty() || (!tokens.front().text.empty() && tokens.front().text[0] == '#'))
+			return false;
+
+		result = tryDispatch(tokens);
+	}
+
+	if(!result && !catch_except)
+		result.rethrow();
+	else if(!result)
+		reportError(result.error());
+
+	return true;
+}
+
+void ArgumentParser::reportError(const ArgumentException &e) const
+{
+	if(e.code() == ArgumentException::TOO_MANY_ARGS_ERROR)
+		std::cout << "ERROR: Please specify multiple arguments as following: arg1 && arg2" << std::endl;
+	else
+		std::cout << e.what() << std::endl;
+}
+
+auto ArgumentParser::notFound(StringRef spelling) const -> ArgumentException
+{
+	std::string info = "The argument " + spelling.str() + " could not be found";
+
+	auto suggestions = suggest(spelling);
+	for(std::size_t pos = 0; pos < suggestions.size(); pos++)
+	{
+		info += (pos == 0) ? ", did you mean " : ((pos + 1 == suggestions.size()) ? " or " : ", ");
+		info += suggestions[pos];
+	}
+
+	if(!suggestions.empty())
+		info += '?';
+
+	return ArgumentException(ArgumentException::ARG_NOT_FOUND_ERROR, info);
+}
+
+auto ArgumentParser::tryDispatch(const std::vector<CommandToken> &tokens) -> ArgumentResult<void>
+{
+	if(concurrency)
+	{
+		// The snapshot and everything reached from it live until the line is done
+		SnapshotDomain::Guard guard(*concurrency->snapshot.domain());
+		return current().tryDispatch(tokens);
+	}
+
+	auto separators = checkSeparators(tokens);
+	if(!separators)
+		return separators;
+
+	// Commands joined by & are collected and run together at the next && or the end
+	std::vector<PendingCommand> group;
+
+	LineData line;
+
+	// Only the functions throw, which stops the line like an error of its own
+	try
+	{
+		bool found_cmd = false;
+		bool piped = false;		// The next command reads the output of the last one
+		for(auto iter = tokens.begin(); iter != tokens.end(); iter++)
+		{
+			if(piped && iter->kind != CommandToken::WORD)
+				return missingPipeCommand();
+
+			if(iter->kind == CommandToken::AND)
+			{
+				runGroup(group);
+				found_cmd = false;
+				continue;
+			}
+			else if(iter->kind == CommandToken::PARALLEL)
+			{
+				found_cmd = false;
+				continue;
+			}
+			else if(iter->kind == CommandToken::PIPE)
+			{
+				if(!found_cmd)
+					return ArgumentException(ArgumentException::SYNTAX_ERROR, "A command has to come before |");
+				else if(!group.back().stream)
+					return ArgumentException(ArgumentException::SYNTAX_ERROR, "The argument " + group.back().spelling.str() + " writes no lines to pipe");
+
+				found_cmd = false;
+				piped = true;
+				continue;
+			}
+			else if(found_cmd)
+				return ArgumentException(ArgumentException::TOO_MANY_ARGS_ERROR, "There were too many arguments specified");
+
+			PendingCommand command{ this, ArgumentHandle(), iter->text, StringRef(), ArgumentValue(), ArgumentValues(), piped, false };
+			auto next = resolve(iter, tokens.end(), command, line);
+			if(!next)
+				return next.error();
+
+			iter = *next;
+			found_cmd = true;
+			piped = false;
+			group.push_back(std::move(command));
+		}
+
+		if(piped)
+			return missingPipeCommand();
+
+		runGroup(group);
+	}
+	catch(const ArgumentException &e)
+	{
+		return ArgumentResult<void>(e, std::current_exception());
+	}
+
+	return ArgumentResult<void>();
+}
+
+auto ArgumentParser::resolve(TokenIter iter, TokenIter end, PendingCommand &command, LineData &line) -> ArgumentResult<TokenIter>
+{
+	auto found_iter = findArgument(iter->text);
+	if(found_iter == args.end())
+		found_iter = findAbbreviation(iter->text);
+
+	if(found_iter == args.end())
+		return notFound(iter->text);
+
+	if(found_iter->flags().isGroup())
+	{
+		auto &scope = group(found_iter->handle()).current();
+		if((iter + 1) != end && (iter + 1)->kind == CommandToken::WORD)
+			return scope.resolve(iter + 1, end, command, line);
+
+		// The name of the group alone shows its help
+		if(!scope.isRegistered(scope.help_handle))
+			return ArgumentException(ArgumentException::NO_USER_DATA_ERROR, "The group " + iter->text.str() + " requires a command");
+
+		command.parser = &scope;
+		command.arg = scope.help_handle;
+		return iter;
+	}
+
+	command.parser = this;
+	command.arg = found_iter->handle();
+	command.spelling = iter->text;
+	command.stream = found_iter->flags().isStream();
+
+	if(command.piped && !command.stream)
+	{
+		// The lines of the pipe are its user data
+		if(!allowsUserData(found_iter->flags()))
+			return ArgumentException(ArgumentException::TOO_MANY_ARGS_ERROR, "The argument " + iter->text.str() + " does not take user data from a pipe");
+	}
+	else if(found_iter->flags().isVariadic())
+	{
+		// No line has more values than tokens, so the buffer never moves and
+		// the slices of earlier commands stay valid
+		auto &values = line.values;
+		values.reserve(end - iter);
+
+		auto arity = found_iter->arity();
+		auto first = values.size();
+		while(values.size() - first < arity.max() && (iter + 1) != end && (iter + 1)->kind == CommandToken::WORD)
+		{
+			if(values.size() - first >= arity.min() && endsValues((iter + 1)->text))
+				break;
+
+			values.push_back((++iter)->text);
+		}
+
+		auto count = values.size() - first;
+		if(count < arity.min())
+			return missingValues(command.spelling, arity);
+
+		if(count != 0)
+			command.values = ArgumentValues(values.data() + first, count);
+	}
+	else if(allowsUserData(found_iter->flags()) && (iter + 1) != end && (iter + 1)->kind == CommandToken::WORD)
+	{
+		// The same argument twice in a row is no user data
+		if(findArgument((iter + 1)->text) == found_iter)
+			return ArgumentException(ArgumentException::TOO_MANY_ARGS_ERROR, "There were too many arguments specified");
+
+		// Both refer to the line, which lives until the commands ran
+		auto value = toValue(*found_iter, iter->text, (iter + 1)->text);
+		if(!value)
+			return value.error();
+
+		command.value = *value;
+		command.user_data = (iter + 1)->text;
+
+		iter++;
+	}
+	else if(config && allowsUserData(found_iter->flags()) && findConfig(*found_iter, line, command.user_data))
+	{
+		// The value lives in the config table the line holds
+		auto value = toValue(*found_iter, iter->text, command.user_data);
+		if(!value)
+			return value.error();
+
+		command.value = *value;
+	}
+	else if(found_iter->flags().isUserDataRequired())
+		return ArgumentException(ArgumentException::NO_USER_DATA_ERROR, "The argument " + iter->text.str() + " requires user data");
+
+	return iter;
+}
+
+void ArgumentParser::runGroup(std::vector<PendingCommand> &group)
+{
+	// Groups are only dropped while none of their commands run
+	RunningScope scope(running);
+
+	// A pipeline is one job of the group, its first command stands for it
+	auto jobEnd = [&](std::size_t first)
+	{
+		auto last = first + 1;
+		while(last < group.size() && group[last].piped)
+			last++;
+
+		return last;
+	};
+
+	if(group.size() == 1)
+		call(group.front());
+	else if(!group.empty() && jobEnd(0) == group.size())
+		runPipeline(group, 0, group.size());
+	else if(!group.empty())
+	{
+		if(!pool)
+			pool.reset(new CommandPool(pool_workers));
+
+		std::vector<std::size_t> jobs;
+		for(std::size_t first = 0; first < group.size(); first = jobEnd(first))
+			jobs.push_back(first);
+
+		// Every job runs to the end, failures are reported together
+		std::vector<std::exception_ptr> failures(jobs.size());
+		auto target = ThreadOutput::current();
+		auto hook = ExitHook::current();
+		pool->runGroup(jobs.size(), [&](std::size_t i)
+		{
+			// The workers write and exit where the line would
+			ThreadOutput output(target);
+			ExitHook exiting(hook);
+
+			try
+			{
+				auto last = jobEnd(jobs[i]);
+				if(last - jobs[i] == 1)
+					call(group[jobs[i]]);
+				else
+					runPipeline(group, jobs[i], last);
+			}
+			catch(...)
+			{
+				failures[i] = std::current_exception();
+			}
+		});
+
+		std::vector<ArgumentGroupException::Error> errors;
+		for(std::size_t i = 0; i < jobs.size(); i++)
+		{
+			if(!failures[i])
+				continue;
+
+			try
+			{
+				std::rethrow_exception(failures[i]);
+			}
+			catch(const ArgumentException &e)
+			{
+				errors.emplace_back(group[jobs[i]].spelling.str(), e);
+			}
+		}
+
+		if(!errors.empty())
+			throw ArgumentGroupException(std::move(errors));
+	}
+
+	group.clear();
+}
+
+void ArgumentParser::runPipeline(const std::vector<PendingCommand> &group, std::size_t first, std::size_t last)
+{
+	// Each command reads from the channel before it and writes to the one after it
+	const auto count = last - first;
+	std::vector<std::unique_ptr<CommandChannel>> channels;
+	for(std::size_t i = 0; i + 1 < count; i++)
+		channels.emplace_back(new CommandChannel());
+
+	std::vector<std::exception_ptr> failures(count);
+	auto target = ThreadOutput::current();
+	auto hook = ExitHook::current();
+	auto stage = [&](std::size_t i)
+	{
+		auto input = (i != 0) ? channels[i - 1].get() : nullptr;
+		auto output = (i + 1 < count) ? channels[i].get() : nullptr;
+		ThreadOutput routed(target);
+		ExitHook exiting(hook);
+
+		try
+		{
+			call(group[first + i], input, output);
+		}
+		catch(...)
+		{
+			failures[i] = std::current_exception();
+		}
+
+		// However it ended, the neighbours must not wait for it
+		if(input != nullptr)
+			input->closeRead();
+		if(output != nullptr)
+			output->closeWrite();
+	};
+
+	// Blocked stages would starve a pool, so each one gets its own thread and
+	// the last runs on this one
+	std::vector<std::thread> threads;
+	threads.reserve(count - 1);
+	try
+	{
+		for(std::size_t i = 0; i + 1 < count; i++)
+			threads.emplace_back(stage, i);
+	}
+	catch(...)
+	{
+		for(auto &channel : channels)
+		{
+			channel->closeRead();
+			channel->closeWrite();
+		}
+
+		for(auto &thread : threads)
+			thread.join();
+
+		throw;
+	}
+
+	stage(count - 1);
+	for(auto &thread : threads)
+		thread.join();
+
+	// The first failure is the cause, the commands after it only lost their input
+	for(auto &failure : failures)
+	{
+		if(failure)
+			std::rethrow_exception(failure);
+	}
+}
+
+#ifdef __linux__
+void ArgumentParser::serve(const std::string &socket_path)
+{
+	CommandServer server(*this, socket_path);
+	server.run();
+}
+#endif
+
+void ArgumentParser::setStatsEnabled(bool enabled)
+{
+	RegistryLock lock(*this);
+
+	// Snapshots keep the stats they were taken with
+	if(!enabled)
+		stats.reset();
+	else if(!stats)
+		stats = std::make_shared<CommandStats>(args.slotCount());
+
+	markChanged();
+
+	// Groups created later start with the same setting
+	for(auto &group : groups)
+	{
+		if(group.parser)
+			group.parser->setStatsEnabled(enabled);
+	}
+}
+
+auto ArgumentParser::isStatsEnabled() const noexcept -> bool
+{
+	return stats != nullptr;
+}
+
+void ArgumentParser::resetStats() noexcept
+{
+	RegistryLock lock(*this);
+	if(stats)
+		stats->reset();
+
+	for(auto &group : groups)
+	{
+		if(group.parser)
+			group.parser->resetStats();
+	}
+}
+
+auto ArgumentParser::getStats() const -> std::vector<CommandStats::Snapshot>
+{
+	RegistryLock lock(*this);
+
+	std::vector<CommandStats::Snapshot> snapshots;
+	if(!stats)
+		return snapshots;
+
+	snapshots.reserve(args.size());
+	for(auto arg : args)
+	{
+		snapshots.push_back(stats->snapshot(args.slot(arg.position())));
+		snapshots.back().name = primarySpelling(arg);
+	}
+
+	return snapshots;
+}
+
+void ArgumentParser::printStats(const std::string &filter) const
+{
+	RegistryLock lock(*this);
+
+	if(!stats)
+	{
+		std::cout << "Stats are disabled, enable them with 'stats on'" << std::endl;
+		return;
+	}
+
+	std::size_t filter_pos = ArgumentIndex::npos;
+	if(!filter.empty())
+	{
+		filter_pos = index.find(filter);
+		if(filter_pos == ArgumentIndex::npos)
+			throw notFound(filter);
+	}
+
+	char line[160];
+	std::string out = "Stats:\n\n";
+	std::snprintf(line, sizeof(line), "    %-24s %10s %8s %10s %10s %10s %10s\n", "command", "calls", "errors", "mean", "p50", "p99", "max");
+	out += line;
+
+	std::size_t shown = 0;
+	for(auto arg : args)
+	{
+		if(filter_pos != ArgumentIndex::npos && arg.position() != filter_pos)
+			continue;
+
+		auto entry = stats->snapshot(args.slot(arg.position()));
+		if(entry.calls == 0)
+			continue;
+
+		entry.name = primarySpelling(arg);
+
+		std::snprintf(line, sizeof(line), "    %-24s %10llu %8llu %10s %10s %10s %10s\n", entry.name.c_str(),
+			static_cast<unsigned long long>(entry.calls), static_cast<unsigned long long>(entry.errors),
+			formatDuration(entry.meanNs()).c_str(), formatDuration(entry.percentileNs(0.5)).c_str(),
+			formatDuration(entry.percentileNs(0.99)).c_str(), formatDuration(entry.max_ns).c_str());
+		out += line;
+		shown++;
+
+		// The errors of a single command are broken down by code
+		for(std::size_t slot = 0; filter_pos != ArgumentIndex::npos && slot < CommandStats::error_slots; slot++)
+		{
+			if(entry.error_counts[slot] == 0)
+				continue;
+
+			std::snprintf(line, sizeof(line), "      %-22s %10llu\n", errorName(slot), static_cast<unsigned long long>(entry.error_counts[slot]));
+			out += line;
+		}
+	}
+
+	if(shown == 0)
+		out += "    No command has been called since the stats were enabled\n";
+
+	std::cout << out << std::endl;
+}
+
+void ArgumentParser::printHistory(StringRef text) const
+{
+	if(!history || history->empty())
+	{
+		std::cout << "The history is empty" << std::endl;
+		return;
+	}
+
+	// The newest matches, shown oldest first like they were typed
+	std::vector<std::uint64_t> numbers;
+	for(auto number = history->searchBackward(text); number != CommandHistory::npos && numbers.size() < history_lines_shown;
+		number = history->searchBackward(text, number))
+		numbers.push_back(number);
+
+	char number_text[32];
+	std::string out;
+	for(auto iter = numbers.rbegin(); iter != numbers.rend(); iter++)
+	{
+		std::snprintf(number_text, sizeof(number_text), "%8llu  ", static_cast<unsigned long long>(*iter));
+		auto line = history->at(*iter);
+		out.append(number_text).append(line.data(), line.size()).push_back('\n');
+	}
+
+	if(numbers.empty())
+		out = "No line of the history contains " + text.str() + "\n";
+
+	std::cout << out << std::flush;
+}
+
+void ArgumentParser::addHistoryArgs()
+{
+	RegistryLock lock(*this);
+
+	// Commands of the application keep their spellings
+	if(index.find("history") == ArgumentIndex::npos)
+	{
+		Argument history_arg;
+		history_arg.command = "history";
+		history_arg.data_info = "text";
+		history_arg.description = "Lists the latest lines or the latest lines containing the text";
+		history_arg.example = exec_name + " > history open";
+		history_arg.flags |= (ArgumentFlags::COMMAND |
+			ArgumentFlags::OPTIONAL |
+			ArgumentFlags::LOOP_ONLY |
+			ArgumentFlags::USER_DATA_ALLOWED);
+		history_arg.func = [&](StringRef text)
+		{
+			printHistory(text);
+		};
+		pushArgument(std::move(history_arg));
+	}
+
+	if(index.find("replay") == ArgumentIndex::npos)
+	{
+		Argument replay_arg;
+		replay_arg.command = "replay";
+		replay_arg.data_info = "first[-last]";
+		replay_arg.description = "Runs lines of the history again";
+		replay_arg.example = exec_name + " > replay 10-20";
+		replay_arg.flags |= (ArgumentFlags::COMMAND |
+			ArgumentFlags::OPTIONAL |
+			ArgumentFlags::LOOP_ONLY |
+			ArgumentFlags::USER_DATA_REQUIRED);
+		replay_arg.func = [&](StringRef range)
+		{
+			// Both ends are included
+			std::string text = range.str();
+			char *end = nullptr;
+			auto first = std::strtoull(text.c_str(), &end, 10);
+			auto last = first;
+			if(end != text.c_str() && *end == '-')
+				last = std::strtoull(end + 1, &end, 10);
+
+			if(text.empty() || !std::isdigit(static_cast<unsigned char>(text[0])) || *end != '\0' || last < first)
+				throw ArgumentException(ArgumentException::INVALID_VALUE_ERROR, "The range " + text + " of replay is no valid range");
+
+			if(history)
+				replay(*history, first, last + 1);
+		};
+		pushArgument(std::move(replay_arg));
+	}
+}
+
+void ArgumentParser::setWorkerCount(std::size_t workers)
+{
+	RegistryLock lock(*this);
+	pool_workers = (workers != 0) ? workers : 1;
+
+	// Snapshots share the pool, they must not create their own
+	if(concurrency)
+		pool = std::make_shared<CommandPool>(pool_workers);
+	else
+		pool.reset();
+
+	markChanged();
+}
+
+void ArgumentParser::setConcurrent(bool enabled)
+{
+	if(enabled == isConcurrent())
+		return;
+
+	if(enabled)
+	{
+		if(!pool)
+			pool = std::make_shared<CommandPool>(pool_workers);
+
+		setSnapshotDomain(std::make_shared<SnapshotDomain>());
+		concurrency->owner = true;
+		return;
+	}
+
+	// No reader is left, so all snapshots can go right away
+	auto domain = concurrency->snapshot.domain();
+	setSnapshotDomain(nullptr);
+	domain->drain();
+}
+
+auto ArgumentParser::isConcurrent() const noexcept -> bool
+{
+	return concurrency != nullptr;
+}
+
+void ArgumentParser::help() const noexcept
+{
+	if(concurrency)
+	{
+		SnapshotDomain::Guard guard(*concurrency->snapshot.domain());
+		current().help();
+		return;
+	}
+
+	// A snapshot renders once for all of its readers, the cache locks itself
+	std::cout << *help_cache.render(args, exec_name);
+}
+
+void ArgumentParser::help(std::string arg_help) const
+{
+	if(concurrency)
+	{
+		SnapshotDomain::Guard guard(*concurrency->snapshot.domain());
+		current().help(arg_help);
+		return;
+	}
+
+	auto pos = index.find(arg_help);
+	if(pos != ArgumentIndex::npos && args[pos].flags().isGroup())
+		group(args.handle(pos)).help();
+	else if(pos != ArgumentIndex::npos)
+		std::cout << help_cache.renderArgument(args[pos]);
+	else
+		helpPage(arg_help, 0);
+}
+
+void ArgumentParser::helpPage(const std::string &filter, std::size_t page, std::size_t page_size) const noexcept
+{
+	if(concurrency)
+	{
+		SnapshotDomain::Guard guard(*concurrency->snapshot.domain());
+		current().helpPage(filter, page, page_size);
+		return;
+	}
+
+	// Pages are not cached
+	std::cout << help_cache.renderPage(args, filter, page, page_size);
+}
@@ -0,0 +1,159 @@
+#include "../headers/arg_response.hpp"
+#include "../headers/arg_exception.hpp"
+#include "../headers/arg_tokenizer.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace CPM_TYR_CN;
+
+const std::size_t ArgvReader::default_max_depth;
+
+ResponseFile::ResponseFile(const std::string &path) :
+	rf_path(path),
+	rf_map(nullptr),
+	rf_size(0),
+	rf_buffer()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		throw ArgumentException(ArgumentException::IO_ERROR, "The response file " + path + " could not be opened");
+
+	struct stat info;
+	if(::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		// Writable but private, the file itself never changes
+		void *map = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if(map != MAP_FAILED)
+		{
+			::madvise(map, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+			rf_map = static_cast<char *>(map);
+			rf_size = static_cast<std::size_t>(info.st_size);
+			::close(fd);
+			return;
+		}
+	}
+
+	char block[4096];
+	ssize_t count;
+	while((count = ::read(fd, block, sizeof(block))) > 0)
+		rf_buffer.insert(rf_buffer.end(), block, block + count);
+
+	::close(fd);
+	if(count < 0)
+		throw ArgumentException(ArgumentException::IO_ERROR, "The response file " + path + " could not be read");
+#else
+	std::ifstream file(path, std::ios::binary);
+	if(!file)
+		throw ArgumentException(ArgumentException::IO_ERROR, "The response file " + path + " could not be opened");
+
+	rf_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+#endif
+
+	rf_size = rf_buffer.size();
+}
+
+ResponseFile::~ResponseFile()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	if(rf_map)
+		::munmap(rf_map, rf_size);
+#endif
+}
+
+auto ResponseFile::begin() noexcept -> char *
+{
+	return rf_map ? rf_map : rf_buffer.data();
+}
+
+auto ResponseFile::end() noexcept -> char *
+{
+	return begin() + rf_size;
+}
+
+auto ResponseFile::path() const noexcept -> const std::string &
+{
+	return rf_path;
+}
+
+ArgvReader::ArgvReader(int argc, char **argv, std::size_t max_depth) :
+	ar_argv(argv),
+	ar_argc(argc),
+	ar_pos(0),
+	ar_max_depth(max_depth),
+	ar_frames(),
+	ar_files(std::make_shared<FileList>()),
+	ar_peeked(),
+	ar_has_peeked(false)
+{
+}
+
+auto ArgvReader::next(StringRef &word) -> bool
+{
+	if(ar_has_peeked)
+	{
+		word = ar_peeked;
+		ar_has_peeked = false;
+		return true;
+	}
+
+	return read(word);
+}
+
+auto ArgvReader::peek(StringRef &word) -> bool
+{
+	if(!ar_has_peeked)
+		ar_has_peeked = read(ar_peeked);
+
+	word = ar_peeked;
+	return ar_has_peeked;
+}
+
+auto ArgvReader::files() const noexcept -> std::shared_ptr<const FileList>
+{
+	return ar_files;
+}
+
+auto ArgvReader::read(StringRef &word) -> bool
+{
+	while(true)
+	{
+		if(!ar_frames.empty())
+		{
+			auto &frame = ar_frames.back();
+			if(!CommandTokenizer::nextWord(frame.iter, frame.last, word))
+			{
+				ar_frames.pop_back();
+				continue;
+			}
+		}
+		else if(ar_pos < ar_argc)
+			word = StringRef(ar_argv[ar_pos++]);
+		else
+			return false;
+
+		// A lone @ is an ordinary word
+		if(ar_max_depth == 0 || word.size() < 2 || word[0] != '@')
+			return true;
+
+		open(word.substr(1));
+	}
+}
+
+void ArgvReader::open(StringRef path)
+{
+	if(ar_frames.size() >= ar_max_depth)
+		throw ArgumentException(ArgumentException::SYNTAX_ERROR, "The response file " + path.str() + " is nested deeper than " + std::to_string(ar_max_depth) + " files");
+
+	ar_files->emplace_back(new ResponseFile(path.str()));
+	auto &file = *ar_files->back();
+	ar_frames.push_back(Frame{ file.begin(), file.end() });
+}
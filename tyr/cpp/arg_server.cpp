@@ -0,0 +1,324 @@
+#include "../headers/arg_server.hpp"
+
+#ifdef __linux__
+
+#include "../headers/arg_exception.hpp"
+#include "../headers/arg_output.hpp"
+#include "../headers/arg_parser.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace CPM_TYR_CN;
+
+namespace
+{
+
+const std::size_t max_line_size = 1 << 20;
+const int max_events = 64;
+
+auto systemError(const std::string &what) -> ArgumentException
+{
+	return ArgumentException(ArgumentException::IO_ERROR, what + ": " + std::strerror(errno));
+}
+
+}
+
+CommandServer::CommandServer(ArgumentParser &parser, std::string socket_path) :
+	cs_parser(parser),
+	cs_path(std::move(socket_path)),
+	cs_listen_fd(-1),
+	cs_epoll_fd(-1),
+	cs_wake_fd(-1),
+	cs_stop(false),
+	cs_clients()
+{
+	// Open as long as the server, so stop() never writes to a closed or reused fd
+	cs_wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(cs_wake_fd < 0)
+		throw systemError("Creating the server failed");
+
+	// Not while serving, the threads of the program may be writing by then
+	ThreadOutput::route();
+}
+
+CommandServer::~CommandServer()
+{
+	close();
+	::close(cs_wake_fd);
+}
+
+void CommandServer::run()
+{
+	open();
+
+	epoll_event events[max_events];
+	while(!cs_stop)
+	{
+		int count = epoll_wait(cs_epoll_fd, events, max_events, -1);
+		if(count < 0)
+		{
+			if(errno == EINTR)
+				continue;
+
+			auto error = systemError("Waiting for clients failed");
+			close();
+			throw error;
+		}
+
+		for(int i = 0; i < count; i++)
+		{
+			int fd = events[i].data.fd;
+			if(fd == cs_listen_fd)
+				accept();
+			else if(fd == cs_wake_fd)
+			{
+				std::uint64_t value;
+				while(::read(cs_wake_fd, &value, sizeof(value)) > 0)
+				{
+				}
+			}
+			else
+			{
+				if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+				{
+					auto iter = cs_clients.find(fd);
+					if(iter != cs_clients.end())
+						receive(fd, iter->second);
+				}
+
+				// The client may have been dropped while receiving
+				if(events[i].events & EPOLLOUT)
+				{
+					auto iter = cs_clients.find(fd);
+					if(iter != cs_clients.end())
+						send(fd, iter->second);
+				}
+			}
+		}
+	}
+
+	// This stop() is used up, the next run() serves again
+	close();
+	cs_stop = false;
+}
+
+void CommandServer::stop() noexcept
+{
+	cs_stop = true;
+
+	std::uint64_t value = 1;
+	(void)::write(cs_wake_fd, &value, sizeof(value));
+}
+
+auto CommandServer::clientCount() const noexcept -> std::size_t
+{
+	return cs_clients.size();
+}
+
+void CommandServer::open()
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(cs_path.size() >= sizeof(address.sun_path))
+		throw ArgumentException(ArgumentException::IO_ERROR, "The socket path " + cs_path + " is too long");
+
+	std::memcpy(address.sun_path, cs_path.c_str(), cs_path.size() + 1);
+
+	cs_listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	cs_epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+	if(cs_listen_fd < 0 || cs_epoll_fd < 0)
+	{
+		auto error = systemError("Creating the server failed");
+		close();
+		throw error;
+	}
+
+	// A socket file left behind by an earlier server would make bind() fail
+	::unlink(cs_path.c_str());
+
+	if(::bind(cs_listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0
+		|| ::listen(cs_listen_fd, SOMAXCONN) < 0)
+	{
+		auto error = systemError("Listening on " + cs_path + " failed");
+		close();
+		throw error;
+	}
+
+	for(int fd : { cs_listen_fd, cs_wake_fd })
+	{
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		::epoll_ctl(cs_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+	}
+}
+
+void CommandServer::close() noexcept
+{
+	while(!cs_clients.empty())
+		drop(cs_clients.begin()->first);
+
+	if(cs_listen_fd >= 0)
+	{
+		::close(cs_listen_fd);
+		::unlink(cs_path.c_str());
+	}
+
+	for(int *fd : { &cs_listen_fd, &cs_epoll_fd })
+	{
+		if(*fd >= 0)
+			::close(*fd);
+
+		*fd = -1;
+	}
+}
+
+void CommandServer::accept()
+{
+	while(true)
+	{
+		int fd = ::accept4(cs_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if(fd < 0)
+			return;
+
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if(::epoll_ctl(cs_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+		{
+			::close(fd);
+			continue;
+		}
+
+		cs_clients[fd] = Client{ std::string(), std::string(), false, false };
+	}
+}
+
+void CommandServer::receive(int fd, Client &client)
+{
+	bool end = false;
+	char chunk[4096];
+	while(true)
+	{
+		auto count = ::read(fd, chunk, sizeof(chunk));
+		if(count > 0)
+			client.input.append(chunk, static_cast<std::size_t>(count));
+		else if(count < 0 && errno == EINTR)
+			continue;
+		else
+		{
+			end = (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK));
+			break;
+		}
+	}
+
+	std::size_t line = 0;
+	while(!client.closing)
+	{
+		auto newline = client.input.find('\n', line);
+		if(newline == std::string::npos)
+			break;
+
+		execute(client, &client.input[line], &client.input[newline]);
+		line = newline + 1;
+	}
+
+	client.input.erase(0, line);
+
+	// A last line without newline still counts when the client is done
+	if(end && !client.closing && !client.input.empty())
+		execute(client, &client.input[0], &client.input[0] + client.input.size());
+
+	if(end || client.input.size() > max_line_size)
+	{
+		client.input.clear();
+		client.closing = true;
+	}
+
+	send(fd, client);
+}
+
+void CommandServer::execute(Client &client, char *first, char *last)
+{
+	std::stringbuf captured;
+	{
+		// Only this thread and the ones running the line write to the client
+		ThreadOutput output(&captured);
+
+		// 'exit' ends this session instead of the whole process, the
+		// terminal and other threads keep theirs
+		std::function<void(int)> close_session = [&](int)
+		{
+			client.closing = true;
+		};
+		ArgumentParser::ExitHook exiting(&close_session);
+
+		try
+		{
+			cs_parser.runLine(first, last, true);
+		}
+		catch(const std::exception &e)
+		{
+			std::cout << "ERROR: " << e.what() << std::endl;
+		}
+	}
+
+	client.output += captured.str();
+}
+
+void CommandServer::send(int fd, Client &client)
+{
+	std::size_t sent = 0;
+	while(sent < client.output.size())
+	{
+		auto count = ::send(fd, client.output.data() + sent, client.output.size() - sent, MSG_NOSIGNAL);
+		if(count > 0)
+			sent += static_cast<std::size_t>(count);
+		else if(count < 0 && errno == EINTR)
+			continue;
+		else if(count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		else
+		{
+			drop(fd);
+			return;
+		}
+	}
+
+	client.output.erase(0, sent);
+
+	// Only ask for EPOLLOUT while there is something left to send
+	bool writing = !client.output.empty();
+	if(writing != client.writing)
+	{
+		epoll_event event;
+		event.events = writing ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+		event.data.fd = fd;
+		::epoll_ctl(cs_epoll_fd, EPOLL_CTL_MOD, fd, &event);
+		client.writing = writing;
+	}
+
+	if(!writing && client.closing)
+		drop(fd);
+}
+
+void CommandServer::drop(int fd) noexcept
+{
+	::epoll_ctl(cs_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+	::close(fd);
+	cs_clients.erase(fd);
+}
+
+#endif // __linux__
@@ -0,0 +1,118 @@
+#include "../headers/arg_snapshot.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+using namespace CPM_TYR_CN;
+
+const std::size_t SnapshotDomain::max_readers;
+
+namespace
+{
+
+// Each thread starts at the slot it got last time, so readers rarely
+// compete for the same one
+thread_local std::size_t reader_hint = 0;
+
+}
+
+SnapshotDomain::Guard::Guard(SnapshotDomain &domain) noexcept :
+	gd_slot(nullptr)
+{
+	while(true)
+	{
+		for(std::size_t i = 0; i < max_readers; i++)
+		{
+			const std::size_t pos = (reader_hint + i) % max_readers;
+			auto &slot = domain.sd_readers[pos];
+
+			// The epoch may move on before it is pinned, an older one only keeps more alive
+			std::uint64_t expected = 0;
+			if(slot.load(std::memory_order_relaxed) == 0 && slot.compare_exchange_strong(expected, domain.sd_epoch.load()))
+			{
+				gd_slot = &slot;
+				reader_hint = pos;
+				return;
+			}
+		}
+
+		// More readers than slots, wait for one to finish
+		std::this_thread::yield();
+	}
+}
+
+SnapshotDomain::Guard::~Guard()
+{
+	gd_slot->store(0, std::memory_order_release);
+}
+
+SnapshotDomain::SnapshotDomain() noexcept :
+	sd_epoch(1),
+	sd_mutex(),
+	sd_retired()
+{
+	for(auto &slot : sd_readers)
+		slot.store(0, std::memory_order_relaxed);
+}
+
+SnapshotDomain::~SnapshotDomain()
+{
+	drain();
+}
+
+void SnapshotDomain::retire(void *object, void (*deleter)(void *))
+{
+	std::vector<Retired> freed;
+	{
+		std::lock_guard<std::mutex> lock(sd_mutex);
+
+		// Readers that pinned this epoch or an older one may have loaded 'object',
+		// later ones load what replaced it
+		sd_retired.push_back(Retired{ object, deleter, sd_epoch.fetch_add(1) });
+
+		std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+		for(auto &slot : sd_readers)
+		{
+			auto epoch = slot.load();
+			if(epoch != 0)
+				oldest = std::min(oldest, epoch);
+		}
+
+		auto kept = std::partition(sd_retired.begin(), sd_retired.end(), [&](const Retired &retired)
+		{
+			return retired.epoch >= oldest;
+		});
+
+		freed.assign(kept, sd_retired.end());
+		sd_retired.erase(kept, sd_retired.end());
+	}
+
+	// Outside the lock, deleting a snapshot may retire others
+	for(auto &retired : freed)
+		retired.deleter(retired.object);
+}
+
+void SnapshotDomain::drain()
+{
+	while(true)
+	{
+		std::vector<Retired> retired;
+		{
+			std::lock_guard<std::mutex> lock(sd_mutex);
+			retired.swap(sd_retired);
+		}
+
+		if(retired.empty())
+			return;
+
+		for(auto &current : retired)
+			current.deleter(current.object);
+	}
+}
+
+auto SnapshotDomain::retiredCount() const -> std::size_t
+{
+	std::lock_guard<std::mutex> lock(sd_mutex);
+	return sd_retired.size();
+}
@@ -0,0 +1,215 @@
+#include "../headers/arg_stats.hpp"
+
+#include <algorithm>
+
+using namespace CPM_TYR_CN;
+
+const std::size_t CommandStats::latency_buckets;
+const std::size_t CommandStats::error_slots;
+const std::size_t CommandStats::max_chunks;
+
+namespace
+{
+
+// floor(log2(value)), 0 for 0
+inline auto highestBit(std::uint64_t value) noexcept -> std::size_t
+{
+#if defined(__GNUC__)
+	return (value > 1) ? static_cast<std::size_t>(63 - __builtin_clzll(value)) : 0;
+#else
+	std::size_t bit = 0;
+	while((value >> (bit + 1)) != 0)
+		bit++;
+
+	return bit;
+#endif
+}
+
+// Limited to the last bucket
+auto bucketOf(std::uint64_t ns) noexcept -> std::size_t
+{
+	return std::min(highestBit(ns), CommandStats::latency_buckets - 1);
+}
+
+// The first chunk has 16 entries
+const std::size_t first_chunk_bits = 4;
+const std::size_t first_chunk = std::size_t(1) << first_chunk_bits;
+
+inline auto chunkOf(std::size_t slot) noexcept -> std::size_t
+{
+	return (slot < first_chunk) ? 0 : highestBit(slot) - first_chunk_bits + 1;
+}
+
+inline auto chunkStart(std::size_t chunk) noexcept -> std::size_t
+{
+	return (chunk == 0) ? 0 : std::size_t(1) << (chunk + first_chunk_bits - 1);
+}
+
+inline auto chunkSize(std::size_t chunk) noexcept -> std::size_t
+{
+	return (chunk == 0) ? first_chunk : chunkStart(chunk);
+}
+
+}
+
+auto CommandStats::Snapshot::meanNs() const noexcept -> std::uint64_t
+{
+	return (calls != 0) ? total_ns / calls : 0;
+}
+
+auto CommandStats::Snapshot::percentileNs(double fraction) const noexcept -> std::uint64_t
+{
+	std::uint64_t total = 0;
+	for(auto count : latency)
+		total += count;
+
+	if(total == 0)
+		return 0;
+
+	const double wanted = fraction * total;
+	std::uint64_t seen = 0;
+	for(std::size_t bucket = 0; bucket < latency_buckets; bucket++)
+	{
+		seen += latency[bucket];
+		if(seen >= wanted && seen != 0)
+			return (bucket + 1 < latency_buckets) ? std::min(std::uint64_t(1) << (bucket + 1), max_ns) : max_ns;
+	}
+
+	return max_ns;
+}
+
+auto CommandStats::Snapshot::errorCount(ArgumentException::ErrorCode code) const noexcept -> std::uint64_t
+{
+	return error_counts[errorSlot(code)];
+}
+
+CommandStats::Entry::Entry() noexcept :
+	calls(0),
+	errors(0),
+	total_ns(0),
+	max_ns(0)
+{
+	for(auto &count : latency)
+		count.store(0, std::memory_order_relaxed);
+
+	for(auto &count : error_counts)
+		count.store(0, std::memory_order_relaxed);
+}
+
+CommandStats::CommandStats(std::size_t size) :
+	cst_size(0)
+{
+	for(auto &chunk : cst_chunks)
+		chunk.store(nullptr, std::memory_order_relaxed);
+
+	resize(size);
+}
+
+CommandStats::~CommandStats()
+{
+	for(auto &chunk : cst_chunks)
+		delete[] chunk.load(std::memory_order_relaxed);
+}
+
+void CommandStats::resize(std::size_t size)
+{
+	if(size <= cst_size)
+		return;
+
+	// Readers only look at slots that existed when they got their registry
+	for(std::size_t chunk = (cst_size != 0) ? chunkOf(cst_size - 1) + 1 : 0; chunk <= chunkOf(size - 1); chunk++)
+		cst_chunks[chunk].store(new Entry[chunkSize(chunk)], std::memory_order_release);
+
+	cst_size = chunkStart(chunkOf(size - 1)) + chunkSize(chunkOf(size - 1));
+}
+
+void CommandStats::reset() noexcept
+{
+	Snapshot zero{};
+	for(std::size_t slot = 0; slot < cst_size; slot++)
+		store(entry(slot), zero);
+}
+
+void CommandStats::reset(std::size_t slot) noexcept
+{
+	Snapshot zero{};
+	store(entry(slot), zero);
+}
+
+void CommandStats::record(std::size_t slot, Clock::duration latency) noexcept
+{
+	count(slot, latency);
+}
+
+void CommandStats::recordError(std::size_t slot, Clock::duration latency, ArgumentException::ErrorCode code) noexcept
+{
+	auto &counted = count(slot, latency);
+	counted.errors.fetch_add(1, std::memory_order_relaxed);
+	counted.error_counts[errorSlot(code)].fetch_add(1, std::memory_order_relaxed);
+}
+
+auto CommandStats::snapshot(std::size_t slot) const -> Snapshot
+{
+	auto &entry = this->entry(slot);
+
+	Snapshot values;
+	values.calls = entry.calls.load(std::memory_order_relaxed);
+	values.errors = entry.errors.load(std::memory_order_relaxed);
+	values.total_ns = entry.total_ns.load(std::memory_order_relaxed);
+	values.max_ns = entry.max_ns.load(std::memory_order_relaxed);
+
+	for(std::size_t bucket = 0; bucket < latency_buckets; bucket++)
+		values.latency[bucket] = entry.latency[bucket].load(std::memory_order_relaxed);
+
+	for(std::size_t slot = 0; slot < error_slots; slot++)
+		values.error_counts[slot] = entry.error_counts[slot].load(std::memory_order_relaxed);
+
+	return values;
+}
+
+auto CommandStats::size() const noexcept -> std::size_t
+{
+	return cst_size;
+}
+
+auto CommandStats::errorSlot(ArgumentException::ErrorCode code) noexcept -> std::size_t
+{
+	return (static_cast<std::size_t>(code) < error_slots - 1) ? static_cast<std::size_t>(code) : error_slots - 1;
+}
+
+auto CommandStats::entry(std::size_t slot) const noexcept -> Entry &
+{
+	auto chunk = chunkOf(slot);
+	return cst_chunks[chunk].load(std::memory_order_acquire)[slot - chunkStart(chunk)];
+}
+
+auto CommandStats::count(std::size_t slot, Clock::duration latency) noexcept -> Entry &
+{
+	auto ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+	auto &entry = this->entry(slot);
+
+	entry.calls.fetch_add(1, std::memory_order_relaxed);
+	entry.total_ns.fetch_add(ns, std::memory_order_relaxed);
+	entry.latency[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+
+	auto max_ns = entry.max_ns.load(std::memory_order_relaxed);
+	while(ns > max_ns && !entry.max_ns.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed))
+	{
+	}
+
+	return entry;
+}
+
+void CommandStats::store(Entry &entry, const Snapshot &values) noexcept
+{
+	entry.calls.store(values.calls, std::memory_order_relaxed);
+	entry.errors.store(values.errors, std::memory_order_relaxed);
+	entry.total_ns.store(values.total_ns, std::memory_order_relaxed);
+	entry.max_ns.store(values.max_ns, std::memory_order_relaxed);
+
+	for(std::size_t bucket = 0; bucket < latency_buckets; bucket++)
+		entry.latency[bucket].store(values.latency[bucket], std::memory_order_relaxed);
+
+	for(std::size_t slot = 0; slot < error_slots; slot++)
+		entry.error_counts[slot].store(values.error_counts[slot], std::memory_order_relaxed);
+}
@@ -0,0 +1,517 @@
+#include "../headers/arg_store.hpp"
+
+#include <utility>
+
+using namespace CPM_TYR_CN;
+
+namespace
+{
+
+auto noValueFunc() -> const ArgumentValueFunc &
+{
+	static const ArgumentValueFunc func;
+	return func;
+}
+
+auto noValuesFunc() -> const ArgumentValuesFunc &
+{
+	static const ArgumentValuesFunc func;
+	return func;
+}
+
+auto noStreamFunc() -> const ArgumentStreamFunc &
+{
+	static const ArgumentStreamFunc func;
+	return func;
+}
+
+}
+
+constexpr std::size_t ArgumentArity::unbounded;
+const std::uint32_t ArgumentStore::no_value_func;
+const std::uint32_t ArgumentStore::no_slot;
+const std::size_t ArgumentStore::npos;
+
+ArgumentView::ArgumentView(const ArgumentStore *store, std::size_t pos) noexcept :
+	avw_store(store),
+	avw_pos(pos)
+{
+}
+
+auto ArgumentView::shortArg() const noexcept -> StringRef
+{
+	return avw_store->as_keys[avw_pos].short_arg;
+}
+
+auto ArgumentView::longArg() const noexcept -> StringRef
+{
+	return avw_store->as_keys[avw_pos].long_arg;
+}
+
+auto ArgumentView::command() const noexcept -> StringRef
+{
+	return avw_store->as_keys[avw_pos].command;
+}
+
+auto ArgumentView::dataInfo() const noexcept -> StringRef
+{
+	return avw_store->as_docs[avw_pos].data_info;
+}
+
+auto ArgumentView::description() const noexcept -> StringRef
+{
+	return avw_store->as_docs[avw_pos].description;
+}
+
+auto ArgumentView::longDescription() const noexcept -> StringRef
+{
+	return avw_store->as_docs[avw_pos].long_description;
+}
+
+auto ArgumentView::example() const noexcept -> StringRef
+{
+	return avw_store->as_docs[avw_pos].example;
+}
+
+auto ArgumentView::flags() const noexcept -> ArgumentFlags
+{
+	return avw_store->as_keys[avw_pos].flags;
+}
+
+auto ArgumentView::valueType() const noexcept -> ArgumentValue::Type
+{
+	return avw_store->as_keys[avw_pos].value_type;
+}
+
+auto ArgumentView::choiceCount() const noexcept -> std::size_t
+{
+	return avw_store->as_docs[avw_pos].choice_count;
+}
+
+auto ArgumentView::choices() const noexcept -> const StringRef *
+{
+	return avw_store->as_choices.data() + avw_store->as_docs[avw_pos].first_choice;
+}
+
+auto ArgumentView::func() const noexcept -> const ArgumentFunc &
+{
+	return avw_store->as_funcs[avw_pos];
+}
+
+auto ArgumentView::valueFunc() const noexcept -> const ArgumentValueFunc &
+{
+	auto &keys = avw_store->as_keys[avw_pos];
+	return (keys.value_func != ArgumentStore::no_value_func && !keys.flags.isVariadic() && !keys.flags.isStream()) ? avw_store->as_value_funcs[keys.value_func] : noValueFunc();
+}
+
+auto ArgumentView::arity() const noexcept -> ArgumentArity
+{
+	auto &keys = avw_store->as_keys[avw_pos];
+	if(keys.flags.isVariadic())
+		return avw_store->as_variadics[keys.value_func].arity;
+
+	return ArgumentArity(keys.flags.isUserDataRequired() ? 1 : 0, (keys.flags.isUserDataAllowed() || keys.flags.isUserDataRequired()) ? 1 : 0);
+}
+
+auto ArgumentView::valuesFunc() const noexcept -> const ArgumentValuesFunc &
+{
+	auto &keys = avw_store->as_keys[avw_pos];
+	return keys.flags.isVariadic() ? avw_store->as_variadics[keys.value_func].func : noValuesFunc();
+}
+
+auto ArgumentView::streamFunc() const noexcept -> const ArgumentStreamFunc &
+{
+	auto &keys = avw_store->as_keys[avw_pos];
+	return keys.flags.isStream() ? avw_store->as_streams[keys.value_func] : noStreamFunc();
+}
+
+auto ArgumentView::position() const noexcept -> std::size_t
+{
+	return avw_pos;
+}
+
+auto ArgumentView::handle() const noexcept -> ArgumentHandle
+{
+	return avw_store->handle(avw_pos);
+}
+
+auto ArgumentView::toArgument() const -> Argument
+{
+	Argument arg;
+	arg.short_arg = shortArg().str();
+	arg.long_arg = longArg().str();
+	arg.command = command().str();
+	arg.data_info = dataInfo().str();
+	arg.description = description().str();
+	arg.long_description = longDescription().str();
+	arg.example = example().str();
+	arg.func = func();
+	arg.flags = flags();
+	arg.value_type = valueType();
+	arg.value_func = valueFunc();
+
+	if(flags().isVariadic())
+	{
+		arg.arity = arity();
+		arg.values_func = valuesFunc();
+	}
+
+	if(flags().isStream())
+		arg.stream_func = streamFunc();
+
+	for(std::size_t pos = 0; pos < choiceCount(); pos++)
+		arg.choices.push_back(choices()[pos].str());
+
+	return arg;
+}
+
+ArgumentStore::ArgumentStore() noexcept :
+	as_pool(),
+	as_keys(),
+	as_docs(),
+	as_choices(),
+	as_funcs(),
+	as_value_funcs(),
+	as_variadics(),
+	as_streams(),
+	as_slots(),
+	as_free_slots(),
+	as_dead(0)
+{
+}
+
+ArgumentStore::ArgumentStore(const ArgumentStore &other) :
+	ArgumentStore()
+{
+	// The texts have to be copied into this store's own pool. The slots are
+	// taken over, so handles of 'other' work with the copy.
+	as_slots = other.as_slots;
+	as_free_slots = other.as_free_slots;
+
+	reserve(other.size());
+	for(auto arg : other)
+	{
+		auto slot = other.as_keys[arg.position()].slot;
+		auto argument = arg.toArgument();
+		addRecord(argument);
+		pushCallables(std::move(argument));
+
+		as_keys.back().slot = slot;
+		as_slots[slot].pos = static_cast<std::uint32_t>(as_keys.size() - 1);
+	}
+}
+
+ArgumentStore::ArgumentStore(ArgumentStore &&other) noexcept :
+	as_pool(std::move(other.as_pool)),
+	as_keys(std::move(other.as_keys)),
+	as_docs(std::move(other.as_docs)),
+	as_choices(std::move(other.as_choices)),
+	as_funcs(std::move(other.as_funcs)),
+	as_value_funcs(std::move(other.as_value_funcs)),
+	as_variadics(std::move(other.as_variadics)),
+	as_streams(std::move(other.as_streams)),
+	as_slots(std::move(other.as_slots)),
+	as_free_slots(std::move(other.as_free_slots)),
+	as_dead(other.as_dead)
+{
+	// Like the pool, the source is left empty
+	other.clear();
+}
+
+auto ArgumentStore::operator =(const ArgumentStore &other) -> ArgumentStore &
+{
+	if(this != &other)
+	{
+		ArgumentStore copy(other);
+		*this = std::move(copy);
+	}
+
+	return *this;
+}
+
+auto ArgumentStore::add(const Argument &arg) -> ArgumentHandle
+{
+	addRecord(arg);
+	pushCallables(arg);
+
+	return assignSlot();
+}
+
+auto ArgumentStore::add(Argument &&arg) -> ArgumentHandle
+{
+	// The texts are copied into the pool either way, only the callables move
+	addRecord(arg);
+	pushCallables(std::move(arg));
+
+	return assignSlot();
+}
+
+auto ArgumentStore::emplace(StringRef short_arg, StringRef long_arg, StringRef command, StringRef description, StringRef example,
+	ArgumentFlags flags, ArgumentFunc &&func) -> ArgumentHandle
+{
+	as_keys.push_back(Keys{ as_pool.store(short_arg), as_pool.store(long_arg), as_pool.store(command), flags, ArgumentValue::STRING, no_value_func, no_slot });
+	as_docs.push_back(Docs{ StringRef(), as_pool.store(description), StringRef(), as_pool.store(example), static_cast<std::uint32_t>(as_choices.size()), 0 });
+	as_funcs.push_back(std::move(func));
+
+	return assignSlot();
+}
+
+auto ArgumentStore::operator =(ArgumentStore &&other) noexcept -> ArgumentStore &
+{
+	if(this != &other)
+	{
+		as_pool = std::move(other.as_pool);
+		as_keys = std::move(other.as_keys);
+		as_docs = std::move(other.as_docs);
+		as_choices = std::move(other.as_choices);
+		as_funcs = std::move(other.as_funcs);
+		as_value_funcs = std::move(other.as_value_funcs);
+		as_variadics = std::move(other.as_variadics);
+		as_streams = std::move(other.as_streams);
+		as_slots = std::move(other.as_slots);
+		as_free_slots = std::move(other.as_free_slots);
+		as_dead = other.as_dead;
+		other.clear();
+	}
+
+	return *this;
+}
+
+void ArgumentStore::reserve(std::size_t count)
+{
+	as_keys.reserve(count);
+	as_docs.reserve(count);
+	as_funcs.reserve(count);
+}
+
+auto ArgumentStore::erase(ArgumentHandle handle) noexcept -> bool
+{
+	auto pos = find(handle);
+	if(pos == npos)
+		return false;
+
+	// A new generation makes every handle of this argument stale
+	auto &slot = as_slots[handle.hd_slot];
+	slot.generation = (slot.generation + 1 != 0) ? slot.generation + 1 : 1;
+	slot.pos = no_slot;
+	as_free_slots.push_back(handle.hd_slot);
+
+	as_keys[pos].slot = no_slot;
+	as_dead++;
+
+	return true;
+}
+
+auto ArgumentStore::eraseIf(const std::function<bool(const ArgumentView &)> &pred) -> std::size_t
+{
+	std::size_t erased = 0;
+	for(auto arg : *this)
+	{
+		if(pred(arg) && erase(arg.handle()))
+			erased++;
+	}
+
+	return erased;
+}
+
+auto ArgumentStore::needsCompaction() const noexcept -> bool
+{
+	// Small stores are not worth it, the rest is amortized over the removals
+	return as_dead >= 32 && as_dead >= size();
+}
+
+void ArgumentStore::compact()
+{
+	if(as_dead != 0)
+	{
+		ArgumentStore kept(*this);
+		*this = std::move(kept);
+	}
+}
+
+void ArgumentStore::clear() noexcept
+{
+	as_keys.clear();
+	as_docs.clear();
+	as_choices.clear();
+	as_funcs.clear();
+	as_value_funcs.clear();
+	as_variadics.clear();
+	as_streams.clear();
+	as_pool.clear();
+	as_slots.clear();
+	as_free_slots.clear();
+	as_dead = 0;
+}
+
+auto ArgumentStore::find(ArgumentHandle handle) const noexcept -> std::size_t
+{
+	if(handle.hd_slot >= as_slots.size())
+		return npos;
+
+	auto &slot = as_slots[handle.hd_slot];
+	return (slot.generation == handle.hd_generation && slot.pos != no_slot) ? slot.pos : npos;
+}
+
+auto ArgumentStore::handle(std::size_t pos) const noexcept -> ArgumentHandle
+{
+	if(!isAlive(pos))
+		return ArgumentHandle();
+
+	auto slot = as_keys[pos].slot;
+	return ArgumentHandle(slot, as_slots[slot].generation);
+}
+
+auto ArgumentStore::isAlive(std::size_t pos) const noexcept -> bool
+{
+	return pos < as_keys.size() && as_keys[pos].slot != no_slot;
+}
+
+auto ArgumentStore::slot(std::size_t pos) const noexcept -> std::size_t
+{
+	return as_keys[pos].slot;
+}
+
+auto ArgumentStore::slotCount() const noexcept -> std::size_t
+{
+	return as_slots.size();
+}
+
+void ArgumentStore::setExample(std::size_t pos, StringRef example)
+{
+	as_docs[pos].example = as_pool.store(example);
+}
+
+void ArgumentStore::setFlags(std::size_t pos, ArgumentFlags flags) noexcept
+{
+	as_keys[pos].flags = flags;
+}
+
+auto ArgumentStore::operator [](std::size_t pos) const noexcept -> ArgumentView
+{
+	return ArgumentView(this, pos);
+}
+
+auto ArgumentStore::size() const noexcept -> std::size_t
+{
+	return as_keys.size() - as_dead;
+}
+
+auto ArgumentStore::recordCount() const noexcept -> std::size_t
+{
+	return as_keys.size();
+}
+
+auto ArgumentStore::capacity() const noexcept -> std::size_t
+{
+	return as_keys.capacity();
+}
+
+auto ArgumentStore::empty() const noexcept -> bool
+{
+	return size() == 0;
+}
+
+auto ArgumentStore::begin() const noexcept -> iterator
+{
+	return iterator(this, nextAlive(0));
+}
+
+auto ArgumentStore::end() const noexcept -> iterator
+{
+	return iterator(this, as_keys.size());
+}
+
+auto ArgumentStore::at(std::size_t pos) const noexcept -> iterator
+{
+	return isAlive(pos) ? iterator(this, pos) : end();
+}
+
+void ArgumentStore::addRecord(const Argument &arg)
+{
+	// Data infos and choices repeat across arguments, the rest hardly ever
+	Keys keys{ as_pool.store(arg.short_arg), as_pool.store(arg.long_arg), as_pool.store(arg.command), arg.flags, arg.value_type, no_value_func, no_slot };
+	Docs docs{ as_pool.intern(arg.data_info), as_pool.store(arg.description), as_pool.store(arg.long_description), as_pool.store(arg.example),
+		static_cast<std::uint32_t>(as_choices.size()), static_cast<std::uint32_t>(arg.choices.size()) };
+
+	for(auto &choice : arg.choices)
+		as_choices.push_back(as_pool.intern(choice));
+
+	// The callables themselves are pushed by the caller
+	if(arg.flags.isVariadic())
+		keys.value_func = static_cast<std::uint32_t>(as_variadics.size());
+	else if(arg.flags.isStream())
+		keys.value_func = static_cast<std::uint32_t>(as_streams.size());
+	else if(arg.value_func)
+		keys.value_func = static_cast<std::uint32_t>(as_value_funcs.size());
+
+	as_keys.push_back(keys);
+	as_docs.push_back(docs);
+}
+
+void ArgumentStore::pushCallables(const Argument &arg)
+{
+	as_funcs.push_back(arg.func);
+
+	if(arg.flags.isVariadic())
+		as_variadics.push_back(Variadic{ arg.arity, arg.values_func });
+	else if(arg.flags.isStream())
+		as_streams.push_back(arg.stream_func);
+	else if(arg.value_func)
+		as_value_funcs.push_back(arg.value_func);
+}
+
+void ArgumentStore::pushCallables(Argument &&arg)
+{
+	as_funcs.push_back(std::move(arg.func));
+
+	if(arg.flags.isVariadic())
+		as_variadics.push_back(Variadic{ arg.arity, std::move(arg.values_func) });
+	else if(arg.flags.isStream())
+		as_streams.push_back(std::move(arg.stream_func));
+	else if(arg.value_func)
+		as_value_funcs.push_back(std::move(arg.value_func));
+}
+
+auto ArgumentStore::assignSlot() -> ArgumentHandle
+{
+	// The last record gets a free slot, generations start at 1
+	std::uint32_t slot;
+	if(!as_free_slots.empty())
+	{
+		slot = as_free_slots.back();
+		as_free_slots.pop_back();
+	}
+	else
+	{
+		slot = static_cast<std::uint32_t>(as_slots.size());
+		as_slots.push_back(Slot{ no_slot, 1 });
+	}
+
+	as_slots[slot].pos = static_cast<std::uint32_t>(as_keys.size() - 1);
+	as_keys.back().slot = slot;
+
+	return ArgumentHandle(slot, as_slots[slot].generation);
+}
+
+auto ArgumentStore::nextAlive(std::size_t pos) const noexcept -> std::size_t
+{
+	while(pos < as_keys.size() && as_keys[pos].slot == no_slot)
+		pos++;
+
+	return pos;
+}
+
+auto ArgumentStore::memoryUsage() const noexcept -> std::size_t
+{
+	return as_pool.memoryUsage()
+		+ as_keys.capacity() * sizeof(Keys)
+		+ as_docs.capacity() * sizeof(Docs)
+		+ as_choices.capacity() * sizeof(StringRef)
+		+ as_funcs.capacity() * sizeof(ArgumentFunc)
+		+ as_value_funcs.capacity() * sizeof(ArgumentValueFunc)
+		+ as_variadics.capacity() * sizeof(Variadic)
+		+ as_streams.capacity() * sizeof(ArgumentStreamFunc)
+		+ as_slots.capacity() * sizeof(Slot)
+		+ as_free_slots.capacity() * sizeof(std::uint32_t);
+}
@@ -0,0 +1,146 @@
+#include "../headers/arg_string_pool.hpp"
+
+#include <cstring>
+#include <utility>
+
+using namespace CPM_TYR_CN;
+
+const std::size_t StringPool::block_size;
+
+StringPool::StringPool() noexcept :
+	sp_blocks(),
+	sp_free(nullptr),
+	sp_left(0),
+	sp_block_bytes(0),
+	sp_table(),
+	sp_count(0)
+{
+}
+
+StringPool::StringPool(StringPool &&other) noexcept :
+	sp_blocks(std::move(other.sp_blocks)),
+	sp_free(other.sp_free),
+	sp_left(other.sp_left),
+	sp_block_bytes(other.sp_block_bytes),
+	sp_table(std::move(other.sp_table)),
+	sp_count(other.sp_count)
+{
+	// The blocks moved along, so the views into them are still valid
+	other.clear();
+}
+
+auto StringPool::operator =(StringPool &&other) noexcept -> StringPool &
+{
+	if(this != &other)
+	{
+		sp_blocks = std::move(other.sp_blocks);
+		sp_free = other.sp_free;
+		sp_left = other.sp_left;
+		sp_block_bytes = other.sp_block_bytes;
+		sp_table = std::move(other.sp_table);
+		sp_count = other.sp_count;
+
+		other.clear();
+	}
+
+	return *this;
+}
+
+auto StringPool::intern(StringRef str) -> StringRef
+{
+	if(str.empty())
+		return StringRef();
+
+	if((sp_count + 1) * 2 > sp_table.size())
+		grow();
+
+	const std::size_t mask = sp_table.size() - 1;
+	std::size_t slot = StringRefHash()(str) & mask;
+	for(; sp_table[slot].data() != nullptr; slot = (slot + 1) & mask)
+	{
+		if(sp_table[slot] == str)
+			return sp_table[slot];
+	}
+
+	sp_table[slot] = store(str);
+	sp_count++;
+
+	return sp_table[slot];
+}
+
+auto StringPool::store(StringRef str) -> StringRef
+{
+	if(str.empty())
+		return StringRef();
+
+	char *data = allocate(str.size() + 1);
+	std::memcpy(data, str.data(), str.size());
+	data[str.size()] = '\0';
+
+	return StringRef(data, str.size());
+}
+
+void StringPool::clear() noexcept
+{
+	sp_blocks.clear();
+	sp_free = nullptr;
+	sp_left = 0;
+	sp_block_bytes = 0;
+	sp_table.clear();
+	sp_count = 0;
+}
+
+auto StringPool::size() const noexcept -> std::size_t
+{
+	return sp_count;
+}
+
+auto StringPool::memoryUsage() const noexcept -> std::size_t
+{
+	return sp_block_bytes + sp_table.capacity() * sizeof(StringRef) + sp_blocks.capacity() * sizeof(std::unique_ptr<char[]>);
+}
+
+auto StringPool::allocate(std::size_t size) -> char *
+{
+	// Long texts get a block of their own so the current one is not wasted
+	if(size > block_size / 4)
+	{
+		sp_blocks.emplace_back(new char[size]);
+		sp_block_bytes += size;
+		return sp_blocks.back().get();
+	}
+
+	if(size > sp_left)
+	{
+		sp_blocks.emplace_back(new char[block_size]);
+		sp_block_bytes += block_size;
+		sp_free = sp_blocks.back().get();
+		sp_left = block_size;
+	}
+
+	char *data = sp_free;
+	sp_free += size;
+	sp_left -= size;
+
+	return data;
+}
+
+void StringPool::grow()
+{
+	std::vector<StringRef> table(sp_table.empty() ? 64 : sp_table.size() * 2);
+	const std::size_t mask = table.size() - 1;
+
+	for(auto &str : sp_table)
+	{
+		if(str.data() == nullptr)
+			continue;
+
+		std::size_t slot = StringRefHash()(str) & mask;
+		while(table[slot].data() != nullptr)
+			slot = (slot + 1) & mask;
+
+		table[slot] = str;
+	}
+
+	sp_table.swap(table);
+}
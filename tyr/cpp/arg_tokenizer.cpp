@@ -0,0 +1,160 @@
+#include "../headers/arg_tokenizer.hpp"
+#include "../headers/arg_exception.hpp"
+
+using namespace CPM_TYR_CN;
+
+namespace
+{
+
+inline auto isSpace(char c) noexcept -> bool
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline auto isAnd(const char *iter, const char *last) noexcept -> bool
+{
+	return iter[0] == '&' && (iter + 1) != last && iter[1] == '&';
+}
+
+inline auto isSeparator(char c) noexcept -> bool
+{
+	return c == '&' || c == '|';
+}
+
+// Removes quotes and escapes of the word at 'iter' in place and moves 'iter'
+// behind it. 'out' never overtakes 'iter', and bytes are only written once
+// it fell behind, so plain words leave the text untouched. 'missing' is set
+// to a quote that is never closed.
+auto scanWord(char *&iter, char *last, bool separators, char &missing) noexcept -> StringRef
+{
+	char *start = iter;
+	char *out = iter;
+	auto copy = [&]()
+	{
+		if(out != iter)
+			*out = *iter;
+
+		out++;
+		iter++;
+	};
+
+	while(iter != last && !isSpace(*iter) && !(separators && isSeparator(*iter)))
+	{
+		if(*iter == '\\' && (iter + 1) != last)
+		{
+			iter++;
+			copy();
+		}
+		else if(*iter == '"' || *iter == '\'')
+		{
+			const char quote = *iter++;
+			while(iter != last && *iter != quote)
+			{
+				// Only double quotes know escapes, like in a shell
+				if(quote == '"' && *iter == '\\' && (iter + 1) != last && (iter[1] == '"' || iter[1] == '\\'))
+					iter++;
+
+				copy();
+			}
+
+			if(iter == last)
+			{
+				missing = quote;
+				break;
+			}
+
+			iter++;
+		}
+		else
+			copy();
+	}
+
+	return StringRef(start, out - start);
+}
+
+auto missingQuote(char quote) -> ArgumentException
+{
+	return ArgumentException(ArgumentException::SYNTAX_ERROR, std::string("Missing closing ") + quote);
+}
+
+}
+
+auto CommandTokenizer::tokenize(std::string &line) -> const std::vector<CommandToken> &
+{
+	return tokenize(&line[0], &line[0] + line.size());
+}
+
+auto CommandTokenizer::tokenize(char *first, char *last) -> const std::vector<CommandToken> &
+{
+	auto missing = split(first, last);
+	if(missing != '\0')
+		throw missingQuote(missing);
+
+	return ct_tokens;
+}
+
+auto CommandTokenizer::tryTokenize(char *first, char *last) -> ArgumentResult<void>
+{
+	auto missing = split(first, last);
+	if(missing != '\0')
+		return missingQuote(missing);
+
+	return ArgumentResult<void>();
+}
+
+auto CommandTokenizer::split(char *first, char *last) -> char
+{
+	ct_tokens.clear();
+
+	char missing = '\0';
+
+	char *iter = first;
+	while(iter != last)
+	{
+		if(isSpace(*iter))
+		{
+			iter++;
+			continue;
+		}
+
+		if(isAnd(iter, last))
+		{
+			ct_tokens.push_back(CommandToken{ StringRef(iter, 2), CommandToken::AND });
+			iter += 2;
+			continue;
+		}
+
+		if(isSeparator(*iter))
+		{
+			ct_tokens.push_back(CommandToken{ StringRef(iter, 1), (*iter == '|') ? CommandToken::PIPE : CommandToken::PARALLEL });
+			iter++;
+			continue;
+		}
+
+		auto word = scanWord(iter, last, true, missing);
+		ct_tokens.push_back(CommandToken{ word, CommandToken::WORD });
+	}
+
+	return missing;
+}
+
+auto CommandTokenizer::nextWord(char *&iter, char *last, StringRef &word) -> bool
+{
+	while(iter != last && isSpace(*iter))
+		iter++;
+
+	if(iter == last)
+		return false;
+
+	char missing = '\0';
+	word = scanWord(iter, last, false, missing);
+	if(missing != '\0')
+		throw missingQuote(missing);
+
+	return true;
+}
+
+auto CommandTokenizer::tokens() const noexcept -> const std::vector<CommandToken> &
+{
+	return ct_tokens;
+}
@@ -0,0 +1,291 @@
+#include "../headers/arg_trie.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using namespace CPM_TYR_CN;
+
+const std::uint32_t ArgumentTrie::none;
+
+ArgumentTrie::ArgumentTrie() :
+	tr_nodes(),
+	tr_free()
+{
+	clear();
+}
+
+void ArgumentTrie::insert(StringRef spelling)
+{
+	if(spelling.empty())
+		return;
+
+	std::uint32_t node = 0;
+	for(auto c : spelling)
+	{
+		auto next = child(node, c);
+		node = (next != none) ? next : addChild(node, c);
+	}
+
+	// Counts only change for a new spelling
+	if(tr_nodes[node].ends++ != 0)
+		return;
+
+	node = 0;
+	tr_nodes[node].count++;
+	for(auto c : spelling)
+	{
+		node = child(node, c);
+		tr_nodes[node].count++;
+	}
+}
+
+void ArgumentTrie::erase(StringRef spelling)
+{
+	auto node = find(spelling);
+	if(spelling.empty() || node == none || tr_nodes[node].ends == 0)
+		return;
+
+	if(--tr_nodes[node].ends != 0)
+		return;
+
+	std::uint32_t parent = 0;
+	tr_nodes[parent].count--;
+	for(auto c : spelling)
+	{
+		node = child(parent, c);
+		if(--tr_nodes[node].count == 0)
+		{
+			// Nothing below is still in use
+			unlink(parent, node);
+			return;
+		}
+
+		parent = node;
+	}
+}
+
+void ArgumentTrie::clear()
+{
+	tr_nodes.assign(1, Node{ none, none, 0, 0, '\0' });
+	tr_free.clear();
+}
+
+auto ArgumentTrie::contains(StringRef spelling) const noexcept -> bool
+{
+	auto node = find(spelling);
+	return !spelling.empty() && node != none && tr_nodes[node].ends != 0;
+}
+
+auto ArgumentTrie::count(StringRef prefix) const noexcept -> std::size_t
+{
+	auto node = find(prefix);
+	return (node != none) ? tr_nodes[node].count : 0;
+}
+
+auto ArgumentTrie::complete(StringRef prefix, std::vector<std::string> &out, std::size_t limit) const -> std::size_t
+{
+	out.clear();
+
+	auto node = find(prefix);
+	if(node == none || tr_nodes[node].count == 0)
+		return 0;
+
+	// Depth-first in sibling order, so the spellings come out sorted
+	std::string spelling = prefix.str();
+	std::vector<std::pair<std::uint32_t, std::size_t>> stack{ { node, spelling.size() } };
+	bool root = true;
+	while(!stack.empty() && out.size() < limit)
+	{
+		auto current = stack.back();
+		stack.pop_back();
+
+		spelling.resize(current.second);
+		if(!root)
+			spelling += tr_nodes[current.first].c;
+
+		root = false;
+
+		if(tr_nodes[current.first].ends != 0)
+			out.push_back(spelling);
+
+		// Push in reverse so the smallest child is handled first
+		std::size_t first = stack.size();
+		for(auto next = tr_nodes[current.first].first_child; next != none; next = tr_nodes[next].next_sibling)
+			stack.emplace_back(next, spelling.size());
+
+		std::reverse(stack.begin() + first, stack.end());
+	}
+
+	return tr_nodes[node].count;
+}
+
+auto ArgumentTrie::unique(StringRef prefix, std::string &spelling) const -> bool
+{
+	auto node = find(prefix);
+	if(node == none || tr_nodes[node].count != 1)
+		return false;
+
+	spelling.assign(prefix.data(), prefix.size());
+	while(tr_nodes[node].ends == 0)
+	{
+		// Unused nodes are unlinked, so the only child is the way on
+		node = tr_nodes[node].first_child;
+		spelling += tr_nodes[node].c;
+	}
+
+	return true;
+}
+
+auto ArgumentTrie::commonPrefix(StringRef prefix) const -> std::string
+{
+	std::string common = prefix.str();
+
+	auto node = find(prefix);
+	if(node == none || tr_nodes[node].count == 0)
+		return common;
+
+	while(tr_nodes[node].ends == 0 && tr_nodes[node].first_child != none && tr_nodes[tr_nodes[node].first_child].next_sibling == none)
+	{
+		node = tr_nodes[node].first_child;
+		common += tr_nodes[node].c;
+	}
+
+	return common;
+}
+
+void ArgumentTrie::similar(StringRef word, std::size_t max_distance, std::vector<Match> &out) const
+{
+	out.clear();
+
+	// Row d of the table belongs to the node at depth d of the current path
+	const std::size_t columns = word.size() + 1;
+	std::vector<std::size_t> rows(columns);
+	for(std::size_t col = 0; col < columns; col++)
+		rows[col] = col;
+
+	std::string path;
+	std::vector<std::pair<std::uint32_t, std::size_t>> stack;
+	for(auto next = tr_nodes[0].first_child; next != none; next = tr_nodes[next].next_sibling)
+		stack.emplace_back(next, 1);
+
+	std::reverse(stack.begin(), stack.end());
+
+	while(!stack.empty())
+	{
+		auto current = stack.back();
+		stack.pop_back();
+
+		const std::size_t depth = current.second;
+		const char c = tr_nodes[current.first].c;
+		path.resize(depth - 1);
+		path.push_back(c);
+
+		rows.resize((depth + 1) * columns);
+		auto *row = rows.data() + depth * columns;
+		auto *above = row - columns;
+
+		row[0] = depth;
+		std::size_t lowest = row[0];
+		for(std::size_t col = 1; col < columns; col++)
+		{
+			row[col] = std::min({ above[col] + 1, row[col - 1] + 1, above[col - 1] + (word[col - 1] != c ? 1 : 0) });
+
+			// Swapped neighbours count as one edit
+			if(depth > 1 && col > 1 && word[col - 1] == path[depth - 2] && word[col - 2] == c)
+				row[col] = std::min(row[col], rows[(depth - 2) * columns + col - 2] + 1);
+
+			lowest = std::min(lowest, row[col]);
+		}
+
+		if(tr_nodes[current.first].ends != 0 && row[columns - 1] <= max_distance)
+			out.emplace_back(path, row[columns - 1]);
+
+		// The distance never shrinks again below this row
+		if(lowest > max_distance)
+			continue;
+
+		std::size_t first = stack.size();
+		for(auto next = tr_nodes[current.first].first_child; next != none; next = tr_nodes[next].next_sibling)
+			stack.emplace_back(next, depth + 1);
+
+		std::reverse(stack.begin() + first, stack.end());
+	}
+
+	// Visited in byte order, which stays the order among equal distances
+	std::stable_sort(out.begin(), out.end(), [](const Match &lhs, const Match &rhs)
+	{
+		return lhs.second < rhs.second;
+	});
+}
+
+auto ArgumentTrie::size() const noexcept -> std::size_t
+{
+	return tr_nodes[0].count;
+}
+
+auto ArgumentTrie::child(std::uint32_t node, char c) const noexcept -> std::uint32_t
+{
+	auto next = tr_nodes[node].first_child;
+	while(next != none && tr_nodes[next].c < c)
+		next = tr_nodes[next].next_sibling;
+
+	return (next != none && tr_nodes[next].c == c) ? next : none;
+}
+
+auto ArgumentTrie::find(StringRef prefix) const noexcept -> std::uint32_t
+{
+	std::uint32_t node = 0;
+	for(std::size_t pos = 0; pos < prefix.size() && node != none; pos++)
+		node = child(node, prefix[pos]);
+
+	return node;
+}
+
+auto ArgumentTrie::addChild(std::uint32_t node, char c) -> std::uint32_t
+{
+	std::uint32_t created;
+	if(!tr_free.empty())
+	{
+		created = tr_free.back();
+		tr_free.pop_back();
+	}
+	else
+	{
+		created = static_cast<std::uint32_t>(tr_nodes.size());
+		tr_nodes.emplace_back();
+	}
+
+	tr_nodes[created] = Node{ none, none, 0, 0, c };
+
+	// Keep the siblings sorted
+	auto *link = &tr_nodes[node].first_child;
+	while(*link != none && tr_nodes[*link].c < c)
+		link = &tr_nodes[*link].next_sibling;
+
+	tr_nodes[created].next_sibling = *link;
+	*link = created;
+
+	return created;
+}
+
+void ArgumentTrie::unlink(std::uint32_t parent, std::uint32_t node) noexcept
+{
+	auto *link = &tr_nodes[parent].first_child;
+	while(*link != node)
+		link = &tr_nodes[*link].next_sibling;
+
+	*link = tr_nodes[node].next_sibling;
+
+	// The whole subtree is free again
+	std::vector<std::uint32_t> stack{ node };
+	while(!stack.empty())
+	{
+		auto current = stack.back();
+		stack.pop_back();
+
+		for(auto next = tr_nodes[current].first_child; next != none; next = tr_nodes[next].next_sibling)
+			stack.push_back(next);
+
+		tr_free.push_back(current);
+	}
+}
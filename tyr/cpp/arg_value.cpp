@@ -0,0 +1,516 @@
+#include "../headers/arg_value.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+using namespace CPM_TYR_CN;
+
+namespace
+{
+
+inline auto isDigit(char c) noexcept -> bool
+{
+	return c >= '0' && c <= '9';
+}
+
+inline auto toLower(char c) noexcept -> char
+{
+	return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+auto equalsIgnoreCase(StringRef text, const char *word) noexcept -> bool
+{
+	std::size_t pos = 0;
+	for(; pos < text.size() && word[pos] != '\0'; pos++)
+	{
+		if(toLower(text[pos]) != word[pos])
+			return false;
+	}
+
+	return pos == text.size() && word[pos] == '\0';
+}
+
+// Reads at least one digit, fails on overflow
+auto parseDigits(const char *&iter, const char *last, unsigned long long &value) noexcept -> bool
+{
+	const char *first = iter;
+	unsigned long long result = 0;
+	for(; iter != last && isDigit(*iter); iter++)
+	{
+		unsigned digit = static_cast<unsigned>(*iter - '0');
+		if(result > (std::numeric_limits<unsigned long long>::max() - digit) / 10)
+			return false;
+
+		result = result * 10 + digit;
+	}
+
+	value = result;
+	return iter != first;
+}
+
+auto multiply(unsigned long long &value, unsigned long long factor) noexcept -> bool
+{
+	if(factor != 0 && value > std::numeric_limits<unsigned long long>::max() / factor)
+		return false;
+
+	value *= factor;
+	return true;
+}
+
+auto parseInt(StringRef text, long long &value) noexcept -> bool
+{
+	const char *iter = text.begin();
+	const char *last = text.end();
+
+	bool negative = false;
+	if(iter != last && (*iter == '-' || *iter == '+'))
+		negative = (*iter++ == '-');
+
+	unsigned long long magnitude;
+	if(!parseDigits(iter, last, magnitude) || iter != last)
+		return false;
+
+	const unsigned long long limit = static_cast<unsigned long long>(std::numeric_limits<long long>::max());
+	if(magnitude > limit + (negative ? 1 : 0))
+		return false;
+
+	value = negative ? static_cast<long long>(0 - magnitude) : static_cast<long long>(magnitude);
+	return true;
+}
+
+template<typename Int>
+auto parseInt(StringRef text, long long &value) noexcept -> bool
+{
+	long long result;
+	if(!parseInt(text, result) || result < std::numeric_limits<Int>::min() || result > std::numeric_limits<Int>::max())
+		return false;
+
+	value = result;
+	return true;
+}
+
+// No minus sign, not even for 0
+template<typename Int>
+auto parseUnsigned(StringRef text, unsigned long long &value) noexcept -> bool
+{
+	const char *iter = text.begin();
+	const char *last = text.end();
+	if(iter != last && *iter == '+')
+		iter++;
+
+	unsigned long long result;
+	if(!parseDigits(iter, last, result) || iter != last || result > std::numeric_limits<Int>::max())
+		return false;
+
+	value = result;
+	return true;
+}
+
+inline auto isSigned(ArgumentValue::Type type) noexcept -> bool
+{
+	return type == ArgumentValue::INT || type == ArgumentValue::INT8 || type == ArgumentValue::INT16 || type == ArgumentValue::INT32;
+}
+
+inline auto isUnsigned(ArgumentValue::Type type) noexcept -> bool
+{
+	return type == ArgumentValue::UINT8 || type == ArgumentValue::UINT16 || type == ArgumentValue::UINT32 || type == ArgumentValue::UINT64;
+}
+
+// Correctly rounded by strtod, for what the exact cases of parseDouble()
+// miss. It gets the digits of [first, last) without the decimal point,
+// which would depend on the locale, and an exponent. More than 800
+// significant digits never change the rounding, the rest only counts as a
+// nonzero digit after them.
+auto roundDecimal(const char *first, const char *last, long long exponent) noexcept -> double
+{
+	const std::size_t max_digits = 800;
+	char buffer[max_digits + 32];
+	std::size_t size = 0;
+	bool fraction = false;
+	bool dropped_nonzero = false;
+	for(; first != last; first++)
+	{
+		if(*first == '.')
+		{
+			fraction = true;
+			continue;
+		}
+
+		if(size == 0 && *first == '0')
+		{
+			// Leading zeros only move the decimal point
+		}
+		else if(size < max_digits)
+			buffer[size++] = *first;
+		else
+		{
+			dropped_nonzero = dropped_nonzero || *first != '0';
+			if(!fraction)
+				exponent++;
+			continue;
+		}
+
+		if(fraction)
+			exponent--;
+	}
+
+	if(size == 0)
+		return 0.0;
+
+	if(dropped_nonzero)
+	{
+		buffer[size++] = '1';
+		exponent--;
+	}
+
+	std::snprintf(buffer + size, sizeof(buffer) - size, "e%lld", exponent);
+	return std::strtod(buffer, nullptr);
+}
+
+auto parseDouble(StringRef text, double &value) noexcept -> bool
+{
+	static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	const char *iter = text.begin();
+	const char *last = text.end();
+
+	bool negative = false;
+	if(iter != last && (*iter == '-' || *iter == '+'))
+		negative = (*iter++ == '-');
+
+	const char *digits_first = iter;
+
+	// Up to 19 significant digits fit into the mantissa, the rest only scale
+	unsigned long long mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool any_digit = false;
+	bool fraction = false;
+	for(; iter != last; iter++)
+	{
+		if(*iter == '.' && !fraction)
+		{
+			fraction = true;
+			continue;
+		}
+		else if(!isDigit(*iter))
+			break;
+
+		any_digit = true;
+		if(digits < 19)
+		{
+			mantissa = mantissa * 10 + static_cast<unsigned>(*iter - '0');
+			if(mantissa != 0)
+				digits++;
+			if(fraction)
+				exponent--;
+		}
+		else if(!fraction)
+			exponent++;
+	}
+
+	if(!any_digit)
+		return false;
+
+	const char *digits_last = iter;
+	long long exp_value = 0;
+	if(iter != last && (*iter == 'e' || *iter == 'E'))
+	{
+		iter++;
+		const char *exp_first = iter;
+		while(iter != last && (isDigit(*iter) || ((*iter == '-' || *iter == '+') && iter == exp_first)))
+			iter++;
+
+		if(!parseInt(StringRef(exp_first, iter - exp_first), exp_value) || exp_value > 10000 || exp_value < -10000)
+			return false;
+
+		exponent += static_cast<int>(exp_value);
+	}
+
+	if(iter != last)
+		return false;
+
+	double result;
+	if(mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+	{
+		// Exact: both factors are representable
+		result = static_cast<double>(mantissa);
+		result = (exponent < 0) ? result / powers[-exponent] : result * powers[exponent];
+	}
+	else
+		result = roundDecimal(digits_first, digits_last, exp_value);
+
+	if(std::isinf(result))
+		return false;
+
+	value = negative ? -result : result;
+	return true;
+}
+
+auto parseBool(StringRef text, bool &value) noexcept -> bool
+{
+	for(auto word : { "true", "yes", "on", "1" })
+	{
+		if(equalsIgnoreCase(text, word))
+		{
+			value = true;
+			return true;
+		}
+	}
+
+	for(auto word : { "false", "no", "off", "0" })
+	{
+		if(equalsIgnoreCase(text, word))
+		{
+			value = false;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+auto parseDuration(StringRef text, long long &nanoseconds) noexcept -> bool
+{
+	struct Unit
+	{
+		const char *name;
+		unsigned long long nanoseconds;
+	};
+
+	static const Unit units[] = {
+		{ "ns", 1ULL }, { "us", 1000ULL }, { "ms", 1000000ULL }, { "min", 60000000000ULL },
+		{ "s", 1000000000ULL }, { "m", 60000000000ULL }, { "h", 3600000000000ULL }, { "d", 86400000000000ULL } };
+
+	const char *iter = text.begin();
+	const char *last = text.end();
+
+	unsigned long long total = 0;
+	bool first_part = true;
+	do
+	{
+		unsigned long long count;
+		if(!parseDigits(iter, last, count))
+			return false;
+
+		const char *unit_first = iter;
+		while(iter != last && !isDigit(*iter))
+			iter++;
+
+		StringRef unit_name(unit_first, iter - unit_first);
+		unsigned long long factor = 0;
+		if(unit_name.empty())
+		{
+			// A plain number means seconds, but only on its own
+			if(!first_part || iter != last)
+				return false;
+
+			factor = 1000000000ULL;
+		}
+
+		for(auto &unit : units)
+		{
+			if(factor == 0 && equalsIgnoreCase(unit_name, unit.name))
+				factor = unit.nanoseconds;
+		}
+
+		if(factor == 0 || !multiply(count, factor) || count > std::numeric_limits<unsigned long long>::max() - total)
+			return false;
+
+		total += count;
+		first_part = false;
+	}
+	while(iter != last);
+
+	if(total > static_cast<unsigned long long>(std::numeric_limits<long long>::max()))
+		return false;
+
+	nanoseconds = static_cast<long long>(total);
+	return true;
+}
+
+auto parseByteSize(StringRef text, unsigned long long &bytes) noexcept -> bool
+{
+	const char *iter = text.begin();
+	const char *last = text.end();
+
+	unsigned long long count;
+	if(!parseDigits(iter, last, count))
+		return false;
+
+	StringRef suffix(iter, last - iter);
+	if(suffix.empty() || equalsIgnoreCase(suffix, "b"))
+	{
+		bytes = count;
+		return true;
+	}
+
+	static const char prefixes[] = { 'k', 'm', 'g', 't', 'p' };
+	unsigned long long factor = 0;
+	for(std::size_t i = 0; i < sizeof(prefixes) && factor == 0; i++)
+	{
+		if(toLower(suffix[0]) != prefixes[i])
+			continue;
+
+		// 4k and 4KiB are binary, 4KB is decimal
+		auto unit = suffix.substr(1);
+		unsigned long long base = 0;
+		if(unit.empty() || equalsIgnoreCase(unit, "ib"))
+			base = 1024;
+		else if(equalsIgnoreCase(unit, "b"))
+			base = 1000;
+		else
+			return false;
+
+		factor = 1;
+		for(std::size_t power = 0; power <= i; power++)
+			factor *= base;
+	}
+
+	if(factor == 0 || !multiply(count, factor))
+		return false;
+
+	bytes = count;
+	return true;
+}
+
+}
+
+ArgumentValue::ArgumentValue() noexcept :
+	av_type(NONE),
+	av_text(),
+	av_unsigned(0)
+{
+}
+
+auto ArgumentValue::convert(Type type, StringRef text, const std::vector<std::string> &choices, ArgumentValue &value) noexcept -> bool
+{
+	return convertValue(type, text, choices, choices.size(), value);
+}
+
+auto ArgumentValue::convert(Type type, StringRef text, const StringRef *choices, std::size_t choice_count, ArgumentValue &value) noexcept -> bool
+{
+	return convertValue(type, text, choices, choice_count, value);
+}
+
+template<typename Choices>
+auto ArgumentValue::convertValue(Type type, StringRef text, const Choices &choices, std::size_t choice_count, ArgumentValue &value) noexcept -> bool
+{
+	ArgumentValue result;
+	result.av_type = type;
+	result.av_text = text;
+
+	bool valid = false;
+	switch(type)
+	{
+	case NONE:
+	case STRING:
+		valid = true;
+		break;
+	case INT:
+		valid = parseInt(text, result.av_int);
+		break;
+	case INT8:
+		valid = parseInt<std::int8_t>(text, result.av_int);
+		break;
+	case INT16:
+		valid = parseInt<std::int16_t>(text, result.av_int);
+		break;
+	case INT32:
+		valid = parseInt<std::int32_t>(text, result.av_int);
+		break;
+	case UINT8:
+		valid = parseUnsigned<std::uint8_t>(text, result.av_unsigned);
+		break;
+	case UINT16:
+		valid = parseUnsigned<std::uint16_t>(text, result.av_unsigned);
+		break;
+	case UINT32:
+		valid = parseUnsigned<std::uint32_t>(text, result.av_unsigned);
+		break;
+	case UINT64:
+		valid = parseUnsigned<std::uint64_t>(text, result.av_unsigned);
+		break;
+	case DOUBLE:
+		valid = parseDouble(text, result.av_double);
+		break;
+	case BOOL:
+		valid = parseBool(text, result.av_bool);
+		break;
+	case ENUM:
+		for(std::size_t pos = 0; pos < choice_count && !valid; pos++)
+		{
+			if(StringRef(choices[pos]) == text)
+			{
+				result.av_unsigned = pos;
+				valid = true;
+			}
+		}
+		break;
+	case DURATION:
+		valid = parseDuration(text, result.av_int);
+		break;
+	case BYTE_SIZE:
+		valid = parseByteSize(text, result.av_unsigned);
+		break;
+	}
+
+	if(valid)
+		value = result;
+
+	return valid;
+}
+
+auto ArgumentValue::type() const noexcept -> Type
+{
+	return av_type;
+}
+
+auto ArgumentValue::empty() const noexcept -> bool
+{
+	return av_type == NONE;
+}
+
+auto ArgumentValue::text() const noexcept -> StringRef
+{
+	return av_text;
+}
+
+auto ArgumentValue::asInt() const noexcept -> long long
+{
+	return isSigned(av_type) ? av_int : (isUnsigned(av_type) ? static_cast<long long>(av_unsigned) : 0);
+}
+
+auto ArgumentValue::asUnsigned() const noexcept -> unsigned long long
+{
+	return isUnsigned(av_type) ? av_unsigned : (isSigned(av_type) ? static_cast<unsigned long long>(av_int) : 0);
+}
+
+auto ArgumentValue::asDouble() const noexcept -> double
+{
+	return (av_type == DOUBLE) ? av_double : (isSigned(av_type) ? static_cast<double>(av_int) : (isUnsigned(av_type) ? static_cast<double>(av_unsigned) : 0.0));
+}
+
+auto ArgumentValue::asBool() const noexcept -> bool
+{
+	return (av_type == BOOL) ? av_bool : false;
+}
+
+auto ArgumentValue::asEnum() const noexcept -> std::size_t
+{
+	return (av_type == ENUM) ? static_cast<std::size_t>(av_unsigned) : 0;
+}
+
+auto ArgumentValue::asDuration() const noexcept -> std::chrono::nanoseconds
+{
+	return std::chrono::nanoseconds((av_type == DURATION) ? av_int : 0);
+}
+
+auto ArgumentValue::asByteSize() const noexcept -> ByteSize
+{
+	return ByteSize{ (av_type == BYTE_SIZE) ? av_unsigned : 0 };
+}
@@ -1,14 +1,25 @@
 #ifndef __ARG__
 #define __ARG__
 
-#include <functional>
 #include <string>
+#include <vector>
 
+#include "arg_arity.hpp"
+#include "arg_callback.hpp"
+#include "arg_channel.hpp"
 #include "arg_flags.hpp"
+#include "arg_value.hpp"
 
 namespace CPM_TYR_CN
 {
 
+// The user data is passed as a view into the line or argv, which is valid
+// for the call. Functions taking a std::string still work and get a copy.
+using ArgumentFunc = ArgumentCallback<StringRef>;
+using ArgumentValueFunc = ArgumentCallback<const ArgumentValue &>;
+using ArgumentValuesFunc = ArgumentCallback<ArgumentValues>;
+using ArgumentStreamFunc = ArgumentCallback<CommandStream &>;
+
 class Argument
 {
 public:
@@ -19,8 +30,24 @@ public:
 	std::string description;
 	std::string long_description;
 	std::string example;
-	std::function<void(std::string)> func;
+	ArgumentFunc func;
 	ArgumentFlags flags;
+
+	// Typed arguments convert their user data once while parsing and call
+	// 'value_func' instead of 'func'
+	ArgumentValue::Type value_type = ArgumentValue::STRING;
+	std::vector<std::string> choices;			// Names of an ENUM value
+	ArgumentValueFunc value_func;
+
+	// VARIADIC arguments take 'arity' values and call 'values_func' once
+	// with all of them instead of 'func'
+	ArgumentArity arity;
+	ArgumentValuesFunc values_func;
+
+	// STREAM arguments read the lines of the command before them in a
+	// pipeline and write lines for the next, see CommandStream. They call
+	// 'stream_func' instead of 'func'.
+	ArgumentStreamFunc stream_func;
 };
 
 }
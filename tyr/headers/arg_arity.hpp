@@ -0,0 +1,118 @@
+#ifndef __ARG_ARITY__
+#define __ARG_ARITY__
+
+#include <cstddef>
+
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// How many values a variadic argument takes. The first min() tokens are
+// taken whatever they look like, further ones up to max() until the next
+// option or argument.
+//
+//     ArgumentArity::exactly(2)		copy <from> <to>
+//     ArgumentArity::atLeast(1)		open <file> [file...]
+//     ArgumentArity::remaining()		touch [file...]
+class ArgumentArity
+{
+public:
+	static constexpr std::size_t unbounded = static_cast<std::size_t>(-1);
+
+public:
+	constexpr ArgumentArity(std::size_t min = 0, std::size_t max = unbounded) noexcept :
+		aa_min(min),
+		aa_max(max < min ? min : max)
+	{
+	}
+
+	static constexpr auto exactly(std::size_t count) noexcept -> ArgumentArity
+	{
+		return ArgumentArity(count, count);
+	}
+
+	static constexpr auto atLeast(std::size_t count) noexcept -> ArgumentArity
+	{
+		return ArgumentArity(count, unbounded);
+	}
+
+	static constexpr auto remaining() noexcept -> ArgumentArity
+	{
+		return ArgumentArity(0, unbounded);
+	}
+
+	constexpr auto min() const noexcept -> std::size_t
+	{
+		return aa_min;
+	}
+
+	constexpr auto max() const noexcept -> std::size_t
+	{
+		return aa_max;
+	}
+
+private:
+	std::size_t aa_min;
+	std::size_t aa_max;
+};
+
+// The values of a variadic argument, a slice of the one buffer all values
+// of a parse or a line are collected in. The texts point into argv or the
+// line, so like a StringRef the values only live as long as the call.
+class ArgumentValues
+{
+public:
+	using const_iterator = const StringRef *;
+
+public:
+	constexpr ArgumentValues() noexcept :
+		avs_data(nullptr),
+		avs_size(0)
+	{
+	}
+
+	constexpr ArgumentValues(const StringRef *data, std::size_t size) noexcept :
+		avs_data(data),
+		avs_size(size)
+	{
+	}
+
+	constexpr auto data() const noexcept -> const StringRef *
+	{
+		return avs_data;
+	}
+
+	constexpr auto size() const noexcept -> std::size_t
+	{
+		return avs_size;
+	}
+
+	constexpr auto empty() const noexcept -> bool
+	{
+		return avs_size == 0;
+	}
+
+	constexpr auto operator [](std::size_t pos) const noexcept -> const StringRef &
+	{
+		return avs_data[pos];
+	}
+
+	constexpr auto begin() const noexcept -> const_iterator
+	{
+		return avs_data;
+	}
+
+	constexpr auto end() const noexcept -> const_iterator
+	{
+		return avs_data + avs_size;
+	}
+
+private:
+	const StringRef *avs_data;
+	std::size_t avs_size;
+};
+
+}
+
+#endif // !__ARG_ARITY__
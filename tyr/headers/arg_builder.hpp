@@ -0,0 +1,49 @@
+#ifndef __ARG_BUILDER__
+#define __ARG_BUILDER__
+
+#include <cstddef>
+#include <string>
+
+#include "arg.hpp"
+#include "arg_flags.hpp"
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+class ArgumentParser;
+
+// Registers many arguments after reserving room for all of them once, e.g.
+//   parser.build(names.size()).add("", "", names[0], ...).add(std::move(arg));
+// Only the added arguments are normalized, nothing registered before is
+// looked at again. A concurrent parser stays locked for changes while the
+// builder lives and publishes the whole batch once when it is destroyed.
+class ArgumentBuilder
+{
+public:
+	ArgumentBuilder(ArgumentBuilder &&orig) noexcept;
+	~ArgumentBuilder();
+
+	ArgumentBuilder(const ArgumentBuilder &) = delete;
+	auto operator =(const ArgumentBuilder &) -> ArgumentBuilder & = delete;
+
+	auto add(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, ArgumentFunc func) -> ArgumentBuilder &;
+	auto add(const Argument &arg) -> ArgumentBuilder &;
+	auto add(Argument &&arg) -> ArgumentBuilder &;
+
+	// Arguments added through this builder
+	auto size() const noexcept -> std::size_t;
+
+private:
+	friend class ArgumentParser;
+
+	ArgumentBuilder(ArgumentParser &parser, std::size_t count);
+
+	ArgumentParser *ab_parser;
+	std::size_t ab_size;
+	bool ab_locked;		// Of a concurrent parser, until the builder is destroyed
+};
+
+}
+
+#endif // !__ARG_BUILDER__
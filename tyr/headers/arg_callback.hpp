@@ -0,0 +1,326 @@
+#ifndef __ARG_CALLBACK__
+#define __ARG_CALLBACK__
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+namespace details
+{
+
+template<typename Func, typename Param, typename = void>
+struct IsCallableWith : std::false_type
+{
+};
+
+template<typename Func, typename Param>
+struct IsCallableWith<Func, Param, decltype(void(std::declval<Func &>()(std::declval<Param>())))> : std::true_type
+{
+};
+
+// Callables of the older std::string signature get a copy of the text
+template<typename Func, typename Param, bool direct = IsCallableWith<Func, Param>::value>
+struct CallbackInvoker
+{
+	static void call(Func &func, Param param)
+	{
+		func(std::forward<Param>(param));
+	}
+};
+
+template<typename Func>
+struct CallbackInvoker<Func, StringRef, false>
+{
+	static void call(Func &func, StringRef param)
+	{
+		func(param.str());
+	}
+};
+
+template<typename Func, typename Param>
+struct IsCallback : std::integral_constant<bool, IsCallableWith<Func, Param>::value
+	|| (std::is_same<Param, StringRef>::value && IsCallableWith<Func, std::string>::value)>
+{
+};
+
+}
+
+// Function of an argument. Callables of up to 'buffer_size' bytes, e.g.
+// lambdas capturing a few pointers, are stored in place without
+// allocating. Larger ones, like a std::function on some ABIs, are kept on
+// the heap. Calling it is one indirect call, an empty callback does nothing.
+template<typename Param>
+class ArgumentCallback
+{
+public:
+	static const std::size_t buffer_size = 4 * sizeof(void *);
+
+public:
+	ArgumentCallback() noexcept :
+		cb_ops(&emptyOps)
+	{
+	}
+
+	ArgumentCallback(std::nullptr_t) noexcept :
+		cb_ops(&emptyOps)
+	{
+	}
+
+	template<typename Func, typename = typename std::enable_if<!std::is_same<typename std::decay<Func>::type, ArgumentCallback>::value
+		&& !std::is_same<typename std::decay<Func>::type, std::nullptr_t>::value
+		&& details::IsCallback<typename std::decay<Func>::type, Param>::value>::type>
+	ArgumentCallback(Func &&func) :
+		cb_ops(&emptyOps)
+	{
+		using Stored = typename std::decay<Func>::type;
+
+		// A std::function or function pointer may be empty itself
+		if(!isEmpty(func))
+			store<Stored>(std::forward<Func>(func), FitsInPlace<Stored>());
+	}
+
+	// Calls 'method' of 'object' through the member pointer, e.g. for
+	// ArgumentParser::add(..., &Class::method, this)
+	template<typename Class, typename MethodParam>
+	ArgumentCallback(Class *object, void (Class::*method)(MethodParam)) :
+		ArgumentCallback(MemberCall<Class, MethodParam>{ object, method })
+	{
+	}
+
+	ArgumentCallback(const ArgumentCallback &other) :
+		cb_ops(other.cb_ops)
+	{
+		cb_ops->copy(cb_buffer, other.cb_buffer);
+	}
+
+	ArgumentCallback(ArgumentCallback &&other) noexcept :
+		cb_ops(other.cb_ops)
+	{
+		cb_ops->move(cb_buffer, other.cb_buffer);
+		other.cb_ops = &emptyOps;
+	}
+
+	~ArgumentCallback()
+	{
+		cb_ops->destroy(cb_buffer);
+	}
+
+	auto operator =(const ArgumentCallback &other) -> ArgumentCallback &
+	{
+		if(this != &other)
+		{
+			ArgumentCallback copy(other);
+			*this = std::move(copy);
+		}
+
+		return *this;
+	}
+
+	auto operator =(ArgumentCallback &&other) noexcept -> ArgumentCallback &
+	{
+		if(this != &other)
+		{
+			cb_ops->destroy(cb_buffer);
+			cb_ops = other.cb_ops;
+			cb_ops->move(cb_buffer, other.cb_buffer);
+			other.cb_ops = &emptyOps;
+		}
+
+		return *this;
+	}
+
+	// The method is part of the type, so the call inlines into the callback:
+	//   ArgumentFunc::bind<Editor, &Editor::open>(editor)
+	template<typename Class, void (Class::*Method)(Param)>
+	static auto bind(Class &object) noexcept -> ArgumentCallback
+	{
+		return ArgumentCallback(BoundMember<Class, Method>{ &object });
+	}
+
+	void operator ()(Param param) const
+	{
+		cb_ops->call(const_cast<char *>(cb_buffer), std::forward<Param>(param));
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return cb_ops != &emptyOps;
+	}
+
+	friend auto operator ==(const ArgumentCallback &callback, std::nullptr_t) noexcept -> bool
+	{
+		return !callback;
+	}
+
+	friend auto operator !=(const ArgumentCallback &callback, std::nullptr_t) noexcept -> bool
+	{
+		return static_cast<bool>(callback);
+	}
+
+private:
+	struct Ops
+	{
+		void (*call)(char *buffer, Param param);
+		void (*copy)(char *to, const char *from);
+		void (*move)(char *to, char *from) noexcept;		// Destroys 'from' too
+		void (*destroy)(char *buffer) noexcept;
+	};
+
+	template<typename Func>
+	struct Model
+	{
+		static void call(char *buffer, Param param)
+		{
+			details::CallbackInvoker<Func, Param>::call(*reinterpret_cast<Func *>(buffer), std::forward<Param>(param));
+		}
+
+		static void copy(char *to, const char *from)
+		{
+			new(to) Func(*reinterpret_cast<const Func *>(from));
+		}
+
+		static void move(char *to, char *from) noexcept
+		{
+			new(to) Func(std::move(*reinterpret_cast<Func *>(from)));
+			reinterpret_cast<Func *>(from)->~Func();
+		}
+
+		static void destroy(char *buffer) noexcept
+		{
+			reinterpret_cast<Func *>(buffer)->~Func();
+		}
+
+		static const Ops ops;
+	};
+
+	// Moving in place must not throw, the moves of the callback do not
+	template<typename Func>
+	struct FitsInPlace : std::integral_constant<bool, sizeof(Func) <= buffer_size && alignof(Func) <= alignof(void *)
+		&& std::is_nothrow_move_constructible<Func>::value>
+	{
+	};
+
+	// The buffer holds a pointer to the callable
+	template<typename Func>
+	struct HeapModel
+	{
+		static void call(char *buffer, Param param)
+		{
+			details::CallbackInvoker<Func, Param>::call(**reinterpret_cast<Func **>(buffer), std::forward<Param>(param));
+		}
+
+		static void copy(char *to, const char *from)
+		{
+			new(to) Func *(new Func(**reinterpret_cast<Func *const *>(from)));
+		}
+
+		static void move(char *to, char *from) noexcept
+		{
+			new(to) Func *(*reinterpret_cast<Func **>(from));
+		}
+
+		static void destroy(char *buffer) noexcept
+		{
+			delete *reinterpret_cast<Func **>(buffer);
+		}
+
+		static const Ops ops;
+	};
+
+	template<typename Class, typename MethodParam>
+	struct MemberCall
+	{
+		Class *object;
+		void (Class::*method)(MethodParam);
+
+		void operator ()(MethodParam param) const
+		{
+			(object->*method)(std::forward<MethodParam>(param));
+		}
+	};
+
+	template<typename Class, void (Class::*Method)(Param)>
+	struct BoundMember
+	{
+		Class *object;
+
+		void operator ()(Param param) const
+		{
+			(object->*Method)(std::forward<Param>(param));
+		}
+	};
+
+	template<typename Stored, typename Func>
+	void store(Func &&func, std::true_type)
+	{
+		new(cb_buffer) Stored(std::forward<Func>(func));
+		cb_ops = &Model<Stored>::ops;
+	}
+
+	template<typename Stored, typename Func>
+	void store(Func &&func, std::false_type)
+	{
+		new(cb_buffer) Stored *(new Stored(std::forward<Func>(func)));
+		cb_ops = &HeapModel<Stored>::ops;
+	}
+
+	static void callNothing(char *, Param)
+	{
+	}
+
+	static void copyNothing(char *, const char *)
+	{
+	}
+
+	static void moveNothing(char *, char *) noexcept
+	{
+	}
+
+	static void destroyNothing(char *) noexcept
+	{
+	}
+
+	template<typename Func>
+	static auto isEmpty(const Func &func) noexcept -> typename std::enable_if<std::is_constructible<bool, const Func &>::value, bool>::type
+	{
+		return !static_cast<bool>(func);
+	}
+
+	template<typename Func>
+	static auto isEmpty(const Func &) noexcept -> typename std::enable_if<!std::is_constructible<bool, const Func &>::value, bool>::type
+	{
+		return false;
+	}
+
+	static const Ops emptyOps;
+
+	const Ops *cb_ops;
+	alignas(void *) char cb_buffer[buffer_size];
+};
+
+template<typename Param>
+const std::size_t ArgumentCallback<Param>::buffer_size;
+
+template<typename Param>
+const typename ArgumentCallback<Param>::Ops ArgumentCallback<Param>::emptyOps = { &ArgumentCallback<Param>::callNothing, &ArgumentCallback<Param>::copyNothing,
+	&ArgumentCallback<Param>::moveNothing, &ArgumentCallback<Param>::destroyNothing };
+
+template<typename Param>
+template<typename Func>
+const typename ArgumentCallback<Param>::Ops ArgumentCallback<Param>::Model<Func>::ops = { &Model<Func>::call, &Model<Func>::copy, &Model<Func>::move, &Model<Func>::destroy };
+
+template<typename Param>
+template<typename Func>
+const typename ArgumentCallback<Param>::Ops ArgumentCallback<Param>::HeapModel<Func>::ops = { &HeapModel<Func>::call, &HeapModel<Func>::copy, &HeapModel<Func>::move,
+	&HeapModel<Func>::destroy };
+
+}
+
+#endif // !__ARG_CALLBACK__
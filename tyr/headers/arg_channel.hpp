@@ -0,0 +1,108 @@
+#ifndef __ARG_CHANNEL__
+#define __ARG_CHANNEL__
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// Lines from one command of a 'cmd1 | cmd2' pipeline to the next, kept in a
+// ring of 'capacity' bytes. The writer waits while the ring is full and the
+// reader while it is empty, so a fast command never runs further ahead of
+// a slow one than twice what the ring holds. Lines longer than the ring are
+// passed on in pieces. One thread writes and one reads.
+//
+// The reader takes everything in the ring at once and hands it out line by
+// line without locking. A waiting reader is woken once an eighth of the
+// ring is filled, not for every line, and waits at most a millisecond for a
+// writer that writes less than that.
+class CommandChannel
+{
+public:
+	static const std::size_t default_capacity = 1 << 16;
+
+public:
+	explicit CommandChannel(std::size_t capacity = default_capacity);
+
+	CommandChannel(const CommandChannel &) = delete;
+	auto operator =(const CommandChannel &) -> CommandChannel & = delete;
+
+	// Appends 'line' and a newline. False once the reader has stopped, the
+	// line is dropped then.
+	auto write(StringRef line) -> bool;
+
+	// Replaces 'line' with the next one, false once the writer has stopped
+	// and every line was read. Reusing 'line' reuses its capacity.
+	auto read(std::string &line) -> bool;
+
+	// The writer is done, the reader gets the rest and then the end
+	void closeWrite();
+
+	// The reader is done, further writes fail instead of waiting forever
+	void closeRead();
+
+private:
+	std::vector<char> chn_ring;
+	std::size_t chn_head;		// Position of the oldest byte
+	std::size_t chn_size;		// Bytes not read yet
+	bool chn_write_closed;
+	bool chn_read_closed;
+	bool chn_reader_waiting;
+	bool chn_writer_waiting;
+	std::size_t chn_wake_size;
+	std::string chn_taken;		// What the reader took out of the ring
+	std::size_t chn_taken_pos;
+	std::mutex chn_mutex;
+	std::condition_variable chn_readable;
+	std::condition_variable chn_writable;
+
+private:
+	// Moves the bytes of the ring to 'chn_taken', false at the end
+	auto take() -> bool;
+};
+
+// What the function of a stream argument gets: its user data, the lines of
+// the command before it in a pipeline and where its own lines go. The last
+// command of a pipeline and a command run on its own write to std::cout.
+//
+//     parser.addStream("", "", "grep", "Lines containing <text>", "", flags, [](CommandStream &stream)
+//     {
+//         std::string line;
+//         while(stream.read(line))
+//         {
+//             if(line.find(stream.userData().str()) != std::string::npos && !stream.write(line))
+//                 break;
+//         }
+//     });
+class CommandStream
+{
+public:
+	CommandStream(StringRef user_data, CommandChannel *input, CommandChannel *output) noexcept;
+
+	auto userData() const noexcept -> StringRef;
+
+	// Next line of the command before this one, false at the end. A command
+	// at the start of a pipeline gets no lines.
+	auto read(std::string &line) -> bool;
+
+	// Waits while the next command is behind. False once it stopped reading,
+	// the rest of the output is not needed then.
+	auto write(StringRef line) -> bool;
+
+	auto isPiped() const noexcept -> bool;
+
+private:
+	StringRef stm_user_data;
+	CommandChannel *stm_input;
+	CommandChannel *stm_output;
+};
+
+}
+
+#endif // !__ARG_CHANNEL__
@@ -0,0 +1,58 @@
+#ifndef __ARG_COMMAND_POOL__
+#define __ARG_COMMAND_POOL__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CPM_TYR_CN
+{
+
+// Fixed number of worker threads, each with its own task queue. Idle
+// workers steal from the other queues. Used to run 'cmd1 & cmd2' groups.
+class CommandPool
+{
+public:
+	explicit CommandPool(std::size_t workers);
+	~CommandPool();
+
+	CommandPool(const CommandPool &) = delete;
+	auto operator =(const CommandPool &) -> CommandPool & = delete;
+
+	// Calls task(0) ... task(count - 1) on the pool and returns when all are
+	// done. The calling thread runs tasks as well while it waits.
+	// 'task' must not throw.
+	void runGroup(std::size_t count, const std::function<void(std::size_t)> &task);
+
+	auto size() const noexcept -> std::size_t;
+
+private:
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue>> cp_queues;
+	std::vector<std::thread> cp_workers;
+	std::mutex cp_wake_mutex;
+	std::condition_variable cp_wake;
+	std::atomic<std::size_t> cp_pending;
+	std::atomic<std::size_t> cp_next_queue;
+	bool cp_stop;
+
+private:
+	void submit(std::function<void()> task);
+	auto tryRun(std::size_t own_queue) -> bool;
+	void work(std::size_t own_queue);
+};
+
+}
+
+#endif // !__ARG_COMMAND_POOL__
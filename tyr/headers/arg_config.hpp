@@ -0,0 +1,112 @@
+#ifndef __ARG_CONFIG__
+#define __ARG_CONFIG__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arg_string_pool.hpp"
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// A config file parsed once: its text and the entries sorted by key, which
+// point into the text. Lines are 'key = value', '#' starts a comment, a value
+// may be quoted and a later key replaces an earlier one.
+//
+//     # myapp.conf
+//     output = out.bin
+//     level = "3"
+class ConfigTable
+{
+public:
+	ConfigTable() noexcept;
+
+	// Throws SYNTAX_ERROR for a line without '=' or a key
+	ConfigTable(std::string text, const std::string &path);
+
+	ConfigTable(const ConfigTable &) = delete;
+	auto operator =(const ConfigTable &) -> ConfigTable & = delete;
+
+	auto find(StringRef key, StringRef &value) const noexcept -> bool;
+	auto size() const noexcept -> std::size_t;
+
+private:
+	struct Entry
+	{
+		StringRef key;
+		StringRef value;
+	};
+
+	std::string ct_text;
+	std::vector<Entry> ct_entries;
+};
+
+// Where the values of arguments come from when the command line or the
+// loop line leaves them out, checked in this order: the environment, the
+// config file and the defaults. All three use the key of an argument, its
+// long spelling without dashes or else its command or short spelling, and
+// environment variables put the prefix before its upper case form:
+//
+//     --output, output = out.bin, MYAPP_OUTPUT=out.bin
+//
+// table() looks at the modification time of the file and only parses it
+// again once it changed, so a running loop sees edits right away.
+class ConfigLayers
+{
+public:
+	ConfigLayers() noexcept;
+
+	ConfigLayers(const ConfigLayers &) = delete;
+	auto operator =(const ConfigLayers &) -> ConfigLayers & = delete;
+
+	// A missing file has no values, it is read once it exists
+	void setFile(std::string path);
+	void setEnvPrefix(std::string prefix);
+	void setDefault(StringRef key, StringRef value);
+
+	// The entries of the file as of now. The values found in a table live as
+	// long as it is held. Throws SYNTAX_ERROR if the file changed and cannot
+	// be parsed, it is not parsed again until it changes once more.
+	auto table() -> std::shared_ptr<const ConfigTable>;
+
+	// Looks through the layers, 'file' is what table() returned
+	auto find(const ConfigTable &file, StringRef key, StringRef &value) const -> bool;
+
+	// How often the file has been parsed
+	auto loadCount() const -> std::size_t;
+
+private:
+	// Tells whether the file changed since it was parsed
+	struct FileStamp
+	{
+		bool exists;
+		std::uint64_t size;
+		std::int64_t seconds;
+		std::int64_t nanoseconds;
+		std::uint64_t inode;
+
+		auto operator ==(const FileStamp &other) const noexcept -> bool;
+	};
+
+	mutable std::mutex cl_mutex;
+	std::string cl_path;
+	std::string cl_env_prefix;
+	std::shared_ptr<const ConfigTable> cl_table;
+	FileStamp cl_stamp;
+	bool cl_checked;		// False until the current file was looked at
+	std::size_t cl_loads;
+
+	// Stored values never move, so an older one stays valid when a default changes
+	StringPool cl_pool;
+	std::unordered_map<StringRef, StringRef, StringRefHash> cl_defaults;
+};
+
+}
+
+#endif // !__ARG_CONFIG__
@@ -3,6 +3,8 @@
 
 #include <exception>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace CPM_TYR_CN
 {
@@ -16,6 +18,10 @@ public:
 		NO_USER_DATA_ERROR,
 		ALIAS_ERROR,
 		TOO_MANY_ARGS_ERROR,
+		SYNTAX_ERROR,
+		IO_ERROR,
+		GROUP_ERROR,
+		INVALID_VALUE_ERROR,
 		UNKNOWN = 0xFFFFFFFF
 	};
 
@@ -23,7 +29,7 @@ public:
 	ArgumentException(ErrorCode error);
 	ArgumentException(ErrorCode error, std::string info);
 
-	virtual auto what() const -> const char *;
+	virtual auto what() const noexcept -> const char * override;
 	auto code() const->ErrorCode;
 
 private:
@@ -31,6 +37,22 @@ private:
 	std::string ex_info;
 };
 
+// Thrown after a 'cmd1 & cmd2' group has finished and at least one of its
+// commands failed. Holds the spelling of every failed command with its error.
+class ArgumentGroupException : public ArgumentException
+{
+public:
+	using Error = std::pair<std::string, ArgumentException>;
+
+public:
+	ArgumentGroupException(std::vector<Error> errors);
+
+	auto errors() const noexcept -> const std::vector<Error> &;
+
+private:
+	std::vector<Error> ex_errors;
+};
+
 }
 
 #endif // !__ARG_EXCEPTION__
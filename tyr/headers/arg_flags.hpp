@@ -17,50 +17,68 @@ public:
 		OPTIONAL			= 0x8,
 		LOOP_ONLY			= 0x10,
 		USER_DATA_ALLOWED	= 0x20,
-		USER_DATA_REQUIRED	= 0x40
+		USER_DATA_REQUIRED	= 0x40,
+		GROUP				= 0x80,
+		VARIADIC			= 0x100,
+		STREAM				= 0x200
 	};
 
 public:
-	ArgumentFlags(unsigned int flags = 0) :
+	constexpr ArgumentFlags(unsigned int flags = 0) :
 		af_flags(flags)
 	{
 	}
 
-	auto hasShortArg() const
+	constexpr auto hasShortArg() const
 	{
 		return (af_flags & SHORT_ARG) ? true : false;
 	}
 
-	auto hasLongArg() const
+	constexpr auto hasLongArg() const
 	{
 		return (af_flags & LONG_ARG) ? true : false;
 	}
 
-	auto hasCommand() const
+	constexpr auto hasCommand() const
 	{
 		return (af_flags & COMMAND) ? true : false;
 	}
 
-	auto isOptional() const
+	constexpr auto isOptional() const
 	{
 		return (af_flags & OPTIONAL) ? true : false;
 	}
 
-	auto isLoopOnly() const
+	constexpr auto isLoopOnly() const
 	{
 		return (af_flags & LOOP_ONLY) ? true : false;
 	}
 
-	auto isUserDataAllowed() const
+	constexpr auto isUserDataAllowed() const
 	{
 		return (af_flags & USER_DATA_ALLOWED) ? true : false;
 	}
 
-	auto isUserDataRequired() const
+	constexpr auto isUserDataRequired() const
 	{
 		return (af_flags & USER_DATA_REQUIRED) ? true : false;
 	}
 
+	constexpr auto isGroup() const
+	{
+		return (af_flags & GROUP) ? true : false;
+	}
+
+	constexpr auto isVariadic() const
+	{
+		return (af_flags & VARIADIC) ? true : false;
+	}
+
+	constexpr auto isStream() const
+	{
+		return (af_flags & STREAM) ? true : false;
+	}
+
 	auto operator ==(const ArgumentFlags &other) const
 	{
 		return (af_flags & other.af_flags) ? true : false;
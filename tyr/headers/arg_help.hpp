@@ -0,0 +1,55 @@
+#ifndef __ARG_HELP__
+#define __ARG_HELP__
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "arg_store.hpp"
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// Renders the help texts of an ArgumentParser. The full help is cached
+// per section: new arguments are appended to the cached sections and only
+// removals or a new exec name make it render everything again.
+//
+// Threads may render at once, e.g. 'help & help'. The sections are only
+// changed under a lock and a finished full help is never changed again, a
+// new one replaces it.
+class ArgumentHelp
+{
+public:
+	ArgumentHelp() noexcept;
+
+	ArgumentHelp(const ArgumentHelp &) = delete;
+	auto operator =(const ArgumentHelp &) -> ArgumentHelp & = delete;
+
+	void invalidate() noexcept;
+	void append(const ArgumentView &arg);
+
+	auto render(const ArgumentStore &args, const std::string &exec_name) -> std::shared_ptr<const std::string>;
+	auto renderArgument(const ArgumentView &arg) const -> std::string;
+
+	// Short one-line entries of all arguments whose spellings or description
+	// contain 'filter', split into pages of 'page_size' entries
+	auto renderPage(const ArgumentStore &args, StringRef filter, std::size_t page, std::size_t page_size) const -> std::string;
+
+private:
+	std::mutex ah_mutex;
+	bool ah_valid;
+	std::string ah_usage;
+	std::string ah_required;
+	std::string ah_optional;
+	std::string ah_examples;
+	std::shared_ptr<const std::string> ah_text;		// nullptr once the sections changed
+
+private:
+	void appendSections(const ArgumentView &arg);
+};
+
+}
+
+#endif // !__ARG_HELP__
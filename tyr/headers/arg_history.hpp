@@ -0,0 +1,86 @@
+#ifndef __ARG_HISTORY__
+#define __ARG_HISTORY__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// Append-only log of command lines in a memory-mapped file, so the lines
+// of loop() survive the process. Lines are kept in a ring of 'data_size'
+// bytes and an index ring of 'max_entries' entries, the oldest lines are
+// dropped when either is full. Opening only maps the file and checks its
+// header, it costs the same for any number of lines.
+//
+// Lines are numbered in the order they were appended, the numbers go on
+// across runs. Each index entry has a mask of the character pairs of its
+// line, so a search skips most lines without looking at their text.
+// Not thread-safe. A process locks the file while it has it open, so
+// only one process uses a history at a time.
+class CommandHistory
+{
+public:
+	static const std::size_t default_data_size = 1 << 20;
+	static const std::size_t default_max_entries = 1 << 14;
+	static const std::uint64_t npos = static_cast<std::uint64_t>(-1);
+
+public:
+	// Creates the file if it does not exist or is no history. An existing
+	// history keeps its own sizes. Throws IO_ERROR if it cannot be mapped
+	// or another process has it open.
+	explicit CommandHistory(const std::string &path, std::size_t data_size = default_data_size, std::size_t max_entries = default_max_entries);
+	~CommandHistory();
+
+	CommandHistory(const CommandHistory &) = delete;
+	auto operator =(const CommandHistory &) -> CommandHistory & = delete;
+
+	// Empty lines and lines longer than the data ring are not kept
+	void append(StringRef line);
+	void clear() noexcept;
+
+	// Writes the mapped pages back to the file now instead of eventually
+	void sync();
+
+	// Lines first() to next() - 1 are kept
+	auto first() const noexcept -> std::uint64_t;
+	auto next() const noexcept -> std::uint64_t;
+	auto size() const noexcept -> std::size_t;
+	auto empty() const noexcept -> bool;
+
+	// Points into the mapping and stays valid until the line is dropped.
+	// Throws ARG_NOT_FOUND_ERROR for a number that is not kept. A damaged
+	// line, whose entry points outside the data, is empty.
+	auto at(std::uint64_t number) const -> StringRef;
+
+	// Number of the newest line before 'before' that contains 'text', or npos
+	auto searchBackward(StringRef text, std::uint64_t before = npos) const noexcept -> std::uint64_t;
+
+	auto path() const noexcept -> const std::string &;
+
+private:
+	struct Header;
+	struct Entry;
+
+	std::string ch_path;
+	int ch_fd;
+	char *ch_map;
+	std::size_t ch_map_size;
+	Header *ch_header;
+	Entry *ch_entries;
+	char *ch_data;
+	std::size_t ch_data_size;			// Of the header when the file was opened
+	std::uint32_t ch_max_entries;
+
+private:
+	auto entry(std::uint64_t number) const noexcept -> const Entry &;
+	// Empty for an entry that points outside the data
+	auto text(const Entry &entry) const noexcept -> StringRef;
+};
+
+}
+
+#endif // !__ARG_HISTORY__
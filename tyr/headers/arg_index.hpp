@@ -0,0 +1,44 @@
+#ifndef __ARG_INDEX__
+#define __ARG_INDEX__
+
+#include <cstddef>
+#include <unordered_map>
+
+#include "arg_store.hpp"
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// Maps every short/long/command spelling to the position of its Argument
+// so that dispatch does not have to scan the whole registry per token.
+class ArgumentIndex
+{
+public:
+	static const std::size_t npos = static_cast<std::size_t>(-1);
+
+public:
+	void insert(const ArgumentView &arg, std::size_t pos);
+	void insert(StringRef spelling, std::size_t pos);
+
+	// Only if 'spelling' maps to 'pos', returns whether it did
+	auto erase(StringRef spelling, std::size_t pos) -> bool;
+
+	void rebuild(const ArgumentStore &args);
+
+	// Room for 'count' spellings in total
+	void reserve(std::size_t count);
+	void clear() noexcept;
+
+	auto find(StringRef spelling) const noexcept -> std::size_t;
+	auto size() const noexcept -> std::size_t;
+
+private:
+	// The keys are the interned spellings of the ArgumentStore, so the index
+	// has to be rebuilt whenever the store is copied or arguments are removed
+	std::unordered_map<StringRef, std::size_t, StringRefHash> ai_map;
+};
+
+}
+
+#endif // !__ARG_INDEX__
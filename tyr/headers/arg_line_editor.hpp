@@ -0,0 +1,76 @@
+#ifndef __ARG_LINE_EDITOR__
+#define __ARG_LINE_EDITOR__
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "arg_history.hpp"
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// Reads the lines of ArgumentParser::loop(). On a terminal it switches to raw
+// mode while a line is read and supports cursor movement, history, reverse
+// search (Ctrl-R) and tab completion, otherwise it reads plain lines like
+// std::getline.
+class LineEditor
+{
+public:
+	struct Completion
+	{
+		std::vector<std::string> candidates;	// The first matches in byte order
+		std::size_t total;						// All matches, may be more than the candidates
+		std::string common;						// Longest prefix all matches share
+	};
+
+	// Fills the completion of the last word of 'line', which is the text in
+	// front of the cursor. Words end at blanks, & and |.
+	using Completer = std::function<void(StringRef line, Completion &completion)>;
+
+public:
+	explicit LineEditor(std::size_t history_size = 1000);
+
+	void setCompleter(Completer completer);
+
+	// Oldest lines are dropped once there are more than 'size'
+	void setHistorySize(std::size_t size);
+	void addHistory(const std::string &line);
+	auto getHistory() const noexcept -> const std::deque<std::string> &;
+
+	// Every line read is appended to 'log' as well and Ctrl-R searches all of
+	// it. The history starts with its latest lines. nullptr detaches it.
+	void setHistoryLog(CommandHistory *log);
+
+	// Prints 'prompt' and reads the next line into 'line', whose capacity is
+	// reused. Non-empty lines are added to the history. Returns false at the
+	// end of input.
+	auto readLine(const std::string &prompt, std::string &line) -> bool;
+
+	// Whether readLine() edits on a terminal instead of reading plain lines
+	static auto isInteractive() noexcept -> bool;
+
+private:
+	Completer le_completer;
+	Completion le_completion;
+	std::deque<std::string> le_history;
+	std::size_t le_history_size;
+	CommandHistory *le_log;
+	std::string le_saved;		// The edited line while browsing the history
+	std::string le_output;		// Reused for every redraw
+
+private:
+	auto readRaw(const std::string &prompt, std::string &line) -> bool;
+	void refresh(const std::string &prompt, const std::string &line, std::size_t cursor);
+	void complete(std::string &line, std::size_t &cursor);
+	void browse(std::string &line, std::size_t &cursor, std::size_t &history_pos, bool older);
+	auto search(std::string &line, std::size_t &cursor, char &key) -> bool;
+	auto findOlder(StringRef text, std::uint64_t before, std::string &found) const -> std::uint64_t;
+};
+
+}
+
+#endif // !__ARG_LINE_EDITOR__
@@ -0,0 +1,42 @@
+#ifndef __ARG_OUTPUT__
+#define __ARG_OUTPUT__
+
+#include <streambuf>
+
+namespace CPM_TYR_CN
+{
+
+// Sends what the current thread writes to std::cout to 'buffer' for as long
+// as it lives, while other threads keep writing where they did. For that
+// a buffer that looks up the target of the writing thread is put in front
+// of std::cout once, by route() or the first ThreadOutput with a buffer,
+// and that must not happen while other threads write.
+// Writes to the targets are serialized, the lines of commands that write
+// at the same time may still interleave.
+//
+// The groups and pipelines of a line run their commands with the target
+// of the thread that dispatched the line. CommandServer uses it to send the
+// output of a line to the client that sent it.
+class ThreadOutput
+{
+public:
+	// nullptr keeps the output where it goes without a ThreadOutput
+	explicit ThreadOutput(std::streambuf *buffer);
+	~ThreadOutput();
+
+	ThreadOutput(const ThreadOutput &) = delete;
+	auto operator =(const ThreadOutput &) -> ThreadOutput & = delete;
+
+	// Target of the innermost ThreadOutput of this thread or nullptr
+	static auto current() noexcept -> std::streambuf *;
+
+	// Routes std::cout by thread from now on, does nothing the second time
+	static void route();
+
+private:
+	std::streambuf *to_previous;
+};
+
+}
+
+#endif // !__ARG_OUTPUT__
@@ -8,89 +8,468 @@
 #ifndef __ARG_PARSER__
 #define	__ARG_PARSER__
 
+#include <atomic>
+#include <cstddef>
+#include <istream>
 #include <string>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <tuple>
+#include <utility>
 
 #include "arg.hpp"
+#include "arg_builder.hpp"
+#include "arg_callback.hpp"
+#include "arg_channel.hpp"
+#include "arg_command_pool.hpp"
+#include "arg_config.hpp"
+#include "arg_exception.hpp"
 #include "arg_flags.hpp"
-#include "arg_utility.hpp"
+#include "arg_help.hpp"
+#include "arg_history.hpp"
+#include "arg_response.hpp"
+#include "arg_result.hpp"
+#include "arg_index.hpp"
+#include "arg_line_editor.hpp"
+#include "arg_snapshot.hpp"
+#include "arg_stats.hpp"
+#include "arg_store.hpp"
+#include "arg_string_ref.hpp"
+#include "arg_tokenizer.hpp"
+#include "arg_trie.hpp"
 
 namespace CPM_TYR_CN
 {
 
 class ArgumentParser 
 {
+	friend class ArgumentBuilder;
+	friend class CommandServer;
+
 public:
     ArgumentParser(std::string exec_name = "") noexcept;
     ArgumentParser(std::vector<Argument> &args_v, std::string exec_name = "") noexcept;
     ArgumentParser(const ArgumentParser& orig) noexcept;
     virtual ~ArgumentParser();
     
-    void add(std::string s_arg, std::string l_arg, std::string cmd, std::string desc, std::string ex, ArgumentFlags flags, std::function<void(std::string)> func) noexcept;
-    void add(Argument &arg) noexcept;
-    void add(std::vector<Argument> &args_v) noexcept;
+	// The texts are copied straight into the registry. The spelling flags
+	// are set from which spellings are given.
+	// The returned handle stays valid until the argument is removed
+	auto add(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, ArgumentFunc func) noexcept -> ArgumentHandle;
+	auto add(const Argument &arg) noexcept -> ArgumentHandle;
+	auto add(Argument &&arg) noexcept -> ArgumentHandle;
+	void add(const std::vector<Argument> &args_v) noexcept;
+	void add(std::vector<Argument> &&args_v) noexcept;
+
+	// Room for 'count' more arguments
+	void reserve(std::size_t count);
+
+	// Runs 'changes' as one change, a concurrent parser publishes once for
+	// all of them instead of after every add() or remove()
+	void update(const std::function<void(ArgumentParser &)> &changes);
+
+	// Reserves for 'count' more arguments and adds them one by one. A
+	// concurrent parser publishes them once when the builder is destroyed.
+	auto build(std::size_t count) -> ArgumentBuilder;
+
+	// Calls the method of 'this_ptr', which takes a StringRef or a std::string.
+	// ArgumentFunc::bind<Class, &Class::method>(object) inlines the call.
+	template<typename Class, typename Param>
+	auto add(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, void (Class::*func)(Param), Class *this_ptr) noexcept -> ArgumentHandle;
+
+	// Typed arguments, e.g. add<int>(...) or add<std::chrono::milliseconds>(...).
+	// The user data is converted once while parsing and 'func' gets the value.
+	// Invalid values throw INVALID_VALUE_ERROR.
+	template<typename Value, typename Func>
+	auto add(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, Func func) noexcept -> ArgumentHandle;
+
+	// A command group with its own arguments and help, run as
+	// '<name> <command> [data]', e.g. 'db migrate'. 'factory' registers the
+	// commands of the group, which may add groups itself. It is called the
+	// first time the group is dispatched, completed or its help is shown, so
+	// unused groups cost nothing but their name. '<name>' alone and
+	// 'help <name>' show the help of the group. On the command line the
+	// arguments after the name belong to the group.
+	auto addGroup(StringRef name, StringRef desc, std::function<void(ArgumentParser &)> factory) noexcept -> ArgumentHandle;
+
+	// The parser of a group, created if it was not used yet. Throws
+	// ARG_NOT_FOUND_ERROR if there is no group called 'name'.
+	auto getGroup(StringRef name) -> ArgumentParser &;
 
-	template<typename Class>
-	void add(std::string s_arg, std::string l_arg, std::string cmd, std::string desc, std::string ex, ArgumentFlags flags, void(Class::* func)(std::string), Class * const this_ptr) noexcept;
+	// Takes 'arity' values, e.g. ArgumentArity::atLeast(1) for 'open f1 f2 f3',
+	// and calls 'func' once with all of them. The values of a parse or a line
+	// are collected in one buffer, 'func' gets its slice.
+	auto addVariadic(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, ArgumentArity arity, ArgumentValuesFunc func) noexcept -> ArgumentHandle;
+
+	// 'func' reads the lines of the command before it in 'cmd1 | cmd2' and
+	// writes lines for the next, see CommandStream. The commands of a
+	// pipeline run at the same time, each on its own thread, and a full
+	// channel makes the writer wait for the reader. Any other command may end
+	// a pipeline, it is called once for every line with the line as its
+	// user data.
+	auto addStream(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, ArgumentStreamFunc func) noexcept -> ArgumentHandle;
+
+	// 'func' gets the index of the choice the user picked
+	auto addChoice(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, std::vector<std::string> choices, std::function<void(std::size_t)> func) noexcept -> ArgumentHandle;
     
-    void remove(std::string match_str);
-    void remove(Argument &arg);
-    void remove(std::vector<Argument> &args_v);
+	// Removing only leaves a tombstone, which costs O(1). The registry is
+	// compacted once there are as many tombstones as arguments.
+	// Returns false for a stale handle.
+	auto remove(ArgumentHandle handle) -> bool;
+
+	// Removes the arguments with this spelling, or if there are none the
+	// ones with this description or example
+	void remove(std::string match_str);
+	void remove(Argument &arg);
+	void remove(std::vector<Argument> &args_v);
+
+	// The view is valid until the registry compacts after removals, keep a
+	// handle to refer to an argument for longer. To change a registered
+	// argument remove it and add getArgument(...).toArgument() again.
+	// Views of a concurrent parser may only be used while no other thread
+	// changes it, e.g. inside update().
+	auto getArgument(std::string match_str) const -> ArgumentView;
 
-	auto getArgument(std::string match_str) const -> const Argument &;
-	auto getArgument(std::string match_str) -> Argument &;
+	// Throws ARG_NOT_FOUND_ERROR for a stale handle
+	auto getArgument(ArgumentHandle handle) const -> ArgumentView;
+
+	// Return the error instead of throwing it, which makes a miss cheap
+	auto tryGetArgument(StringRef match_str) const -> ArgumentResult<ArgumentView>;
+	auto tryGetArgument(ArgumentHandle handle) const -> ArgumentResult<ArgumentView>;
+	auto isRegistered(ArgumentHandle handle) const noexcept -> bool;
 
 	auto getUserData(std::string match_str) const -> std::string;
 	auto getUserData(Argument &arg) const -> std::string;
 
+	// The converted value of a typed argument from the last parse()
+	auto getValue(std::string match_str) const -> ArgumentValue;
+
+	// The values of a variadic argument from the last parse(), valid until the next one
+	auto getValues(std::string match_str) const -> ArgumentValues;
+
 	void setAlias(std::string existing_arg, Argument &alias);
 	void setAlias(Argument &existing_arg, Argument &alias);
     
+	// A token @path is replaced by the words of that file, see ArgvReader.
+	// Throws IO_ERROR for a file that cannot be read.
 	void parse(int argc, char **argv, bool execute_funcs = true);
+
+	// Returns what parse() would throw. Exceptions thrown by the functions of
+	// the arguments are returned too, rethrow() throws them as they were.
+	// A concurrent parser parses on a snapshot like a line, so changes made
+	// meanwhile, also by the functions, do not wait for the parse.
+	auto tryParse(int argc, char **argv, bool execute_funcs = true) -> ArgumentResult<void>;
+
+	// Tokens that are no arguments and everything after '--'. They point into
+	// argv or into response files, which are kept until the next parse().
+	// A copy, so a parse() on another thread does not change it meanwhile.
+	auto getPositional() const -> std::vector<StringRef>;
+
+	// How deep response files may name further ones, 0 takes @path literally
+	void setResponseFileDepth(std::size_t depth) noexcept;
+
+	// Values of arguments the command line or a loop line leaves out come from
+	// the environment, a config file and defaults, see ConfigLayers. parse()
+	// runs every argument that has such a value, flags without user data for
+	// true, yes, on or 1. A loop command without user data gets its value.
+	// Only the arguments of this parser are looked up, not those of groups.
+	auto getConfig() -> ConfigLayers &;
     
+	// On a terminal the lines are read with the line editor, tab completes
+	// spellings and unique prefixes of commands run them, e.g. 'sa' for 'save'
     auto loop(int argc, char **argv, bool catch_except = true) -> int;
+
+	// Completes 'prefix' to the short/long/command spellings starting with it.
+	// At most 'limit' candidates are listed, the total counts all of them.
+	void complete(StringRef prefix, LineEditor::Completion &completion, std::size_t limit = 100) const;
+
+	// Completes the last word of 'line' among the commands of the groups
+	// named in front of it, e.g. 'db mi' to 'db migrate'
+	void completeLine(StringRef line, LineEditor::Completion &completion, std::size_t limit = 100) const;
+
+	// Registered spellings closest to an unknown one, e.g. 'save' for 'svae'.
+	// Unknown arguments and commands add them to their error message.
+	auto suggest(StringRef spelling, std::size_t limit = 3) const -> std::vector<std::string>;
+
+	// The editor of loop(), e.g. for its history
+	auto getLineEditor() noexcept -> LineEditor &;
+
+	// Keeps the lines of loop() in a memory-mapped CommandHistory at 'path',
+	// which the line editor starts with and searches with Ctrl-R. Adds the
+	// loop commands 'history [text]', which lists the latest lines or those
+	// containing 'text', and 'replay <first>[-<last>]' unless these
+	// spellings are taken. Throws IO_ERROR if the file cannot be mapped or
+	// another process has it open.
+	void setHistoryFile(const std::string &path, std::size_t data_size = CommandHistory::default_data_size,
+		std::size_t max_entries = CommandHistory::default_max_entries);
+
+	// nullptr without a history file
+	auto getHistory() noexcept -> CommandHistory *;
+
+	// Runs the lines 'first' to 'last' - 1 of 'history' like run() does,
+	// without prompts and without adding them to a history again. Lines no
+	// longer kept are skipped. A replay started by a replayed line runs
+	// nothing, so replaying the line that started it cannot loop forever.
+	// Returns the number of executed command lines.
+	auto replay(const CommandHistory &history, std::uint64_t first, std::uint64_t last, bool catch_except = true) -> std::size_t;
+
+	// Runs 'line' like a loop() line, which is tokenized in place. Unknown
+	// commands, bad user data and the exceptions of the functions are
+	// returned instead of thrown.
+	auto tryDispatch(std::string &line) -> ArgumentResult<void>;
+
+	// Runs every line of 'input' like a loop() line but without prompts.
+	// Empty lines and lines starting with '#' are skipped.
+	// Returns the number of executed command lines.
+	auto run(std::istream &input, bool catch_except = true) -> std::size_t;
+	auto runScript(const std::string &path, bool catch_except = true) -> std::size_t;
+
+	// Number of threads that run 'cmd1 & cmd2 & cmd3' groups. Their functions
+	// are called concurrently and have to be thread-safe.
+	// Must not be called while commands are running.
+	void setWorkerCount(std::size_t workers);
+
+	// Prints one page of short help entries whose spellings or description
+	// contain 'filter'. 'page' starts at 0. 'help <text>' for an unknown
+	// argument prints the first page.
+	void helpPage(const std::string &filter, std::size_t page, std::size_t page_size = 50) const noexcept;
+
+	// Records calls, errors and latencies of every function while enabled.
+	// Disabled (the default) calls are not timed at all. The built-in
+	// 'stats' command does the same: stats on|off|reset|<command>.
+	void setStatsEnabled(bool enabled);
+	auto isStatsEnabled() const noexcept -> bool;
+	void resetStats() noexcept;
+
+	// One entry per registered argument, named by its command, long or short
+	// argument. Empty while stats are disabled.
+	auto getStats() const -> std::vector<CommandStats::Snapshot>;
+
+	// Lets other threads run lines, complete and show help while arguments
+	// are added and removed. Readers use an immutable snapshot of the
+	// registry they get without locking, so a line sees the registry as it
+	// was when the line started. Every change copies the registry and
+	// publishes the copy, use update() for many changes at once. Groups
+	// follow the setting. Must not be called while other threads use the
+	// parser.
+	void setConcurrent(bool enabled);
+	auto isConcurrent() const noexcept -> bool;
+
+#ifdef __linux__
+	// Serves the commands to local clients for as long as the process runs,
+	// see CommandServer. Run a CommandServer instead to stop() it again.
+	void serve(const std::string &socket_path);
+#endif
     
 private:
-	using ArgIter = std::vector<Argument>::iterator;
+	using ArgIter = ArgumentStore::iterator;
+
+	// Results refer to their argument by handle, so removing arguments after
+	// a parse cannot leave them dangling
+	// The last two are the first value and the number of values of a variadic
+	// argument in 'parsed_values'
+	using ParsedArgument = std::tuple<ArgumentHandle, std::string, ArgumentValue, std::size_t, std::size_t>;
+
+	// What a parse leaves behind. A concurrent parser parses on a snapshot
+	// into results of its own and only swaps them in at the end.
+	struct ParseResults
+	{
+		std::vector<ParsedArgument> parsed;
+		std::vector<StringRef> positional;
+		std::vector<StringRef> values;		// Of all variadic arguments
+		std::shared_ptr<const ArgvReader::FileList> response_files;		// Positionals and values may point into them
+		std::shared_ptr<const ConfigTable> config_table;		// Values taken from the config point into it
+	};
+
+	using TokenIter = std::vector<CommandToken>::const_iterator;
+
+	// Commands of groups run on the parser of their group. They are looked
+	// up again when they run, earlier commands may have removed them.
+	struct PendingCommand
+	{
+		ArgumentParser *parser;
+		ArgumentHandle arg;
+		StringRef spelling;
+		StringRef user_data;		// Into the line, which lives until the commands ran
+		ArgumentValue value;
+		ArgumentValues values;		// Of a variadic argument
+		bool piped;			// Reads the lines of the command before it
+		bool stream;		// Writes lines the next command may read
+	};
+
+	// What the commands of a line point into besides the line
+	struct LineData
+	{
+		std::vector<StringRef> values;		// Of variadic commands, only allocated if the line has any
+		std::shared_ptr<const ConfigTable> config;		// Taken when a command needs it
+	};
+
+	struct CommandGroup
+	{
+		ArgumentHandle handle;		// Of the group's command in this parser
+		std::function<void(ArgumentParser &)> factory;
+		std::shared_ptr<ArgumentParser> parser;		// Created on first use, shared with snapshots
+	};
+
+	enum class Scope
+	{
+		ROOT,
+		GROUP,
+		SNAPSHOT
+	};
+
+	// Lock and snapshots of a concurrent parser, see arg_parser.cpp
+	struct Concurrency;
+	class RegistryLock;
+
+	// Replaces exit() for the built-in exit command while it lives, on this
+	// thread and the threads running the groups and pipelines of its lines.
+	// CommandServer uses it so 'exit' ends the session of a client.
+	class ExitHook
+	{
+	public:
+		explicit ExitHook(const std::function<void(int)> *hook) noexcept;
+		~ExitHook();
+
+		ExitHook(const ExitHook &) = delete;
+		auto operator =(const ExitHook &) -> ExitHook & = delete;
+
+		// Hook of the innermost ExitHook of this thread or nullptr
+		static auto current() noexcept -> const std::function<void(int)> *;
 
-    std::vector<Argument> args;
-	std::vector<std::tuple<ArgIter, std::string>> parsed;
+	private:
+		const std::function<void(int)> *eh_previous;
+	};
+
+	ArgumentStore args;
+	ArgumentIndex index;
+	ArgumentTrie trie;		// Follows the index for completions and abbreviations
+	ParseResults parse_results;		// Of the last parse
+	mutable std::mutex parse_mutex;		// Guards 'parse_results', not the registry
+	std::size_t response_depth;
+	std::shared_ptr<ConfigLayers> config;		// Created by getConfig(), shared with snapshots
 	std::string exec_name;
 	std::string exec_path;
+	CommandTokenizer tokenizer;
+	mutable ArgumentHelp help_cache;
+	std::shared_ptr<CommandPool> pool;		// Created by the first parallel group
+	std::size_t pool_workers;
+	std::shared_ptr<CommandStats> stats;	// Only exists while stats are enabled
+	LineEditor line_editor;
+	std::unique_ptr<CommandHistory> history;		// Only exists with a history file
+	ArgumentHandle help_handle;
+	std::atomic<std::size_t> running;		// Functions being called, no compaction meanwhile
+	mutable std::vector<CommandGroup> groups;
+	std::unique_ptr<Concurrency> concurrency;	// Only exists in concurrent mode
+	ArgumentParser *origin;		// The parser a snapshot was taken from
 
 private:
-	inline auto compareArgs(const Argument &arg, std::string &str) const noexcept -> bool;
-	inline auto compareArgs(Argument &arg, Argument &other_arg) const noexcept -> bool;
+	// The parser of a group only has the help argument
+	ArgumentParser(std::string exec_name, Scope scope) noexcept;
+
+	// Read-only copy of the registry for the readers of a concurrent parser
+	ArgumentParser(const ArgumentParser &orig, Scope scope) noexcept;
+
+	inline auto compareArgs(const ArgumentView &arg, std::string &str) const noexcept -> bool;
+	inline auto compareArgs(const ArgumentView &arg, const Argument &other_arg) const noexcept -> bool;
+
+	auto findArgument(StringRef spelling) noexcept -> ArgIter;
+	auto findArgument(const Argument &arg) noexcept -> ArgIter;
+	auto findAbbreviation(StringRef prefix) noexcept -> ArgIter;
+	auto pushArgument(const Argument &arg) -> ArgumentHandle;
+	auto pushArgument(Argument &&arg) -> ArgumentHandle;
+	void registerLast();
+	void removeIf(const std::function<bool(const ArgumentView &)> &pred);
+	void removeAt(std::size_t pos);
+	void finishRemoval();
+
+	auto findArgvArgument(StringRef spelling) noexcept -> ArgIter;
+	auto tryParse(ArgvReader &reader, StringRef name, bool execute_funcs) -> ArgumentResult<void>;
+	auto parseInto(ArgvReader &reader, bool execute_funcs, ParseResults &results) -> ArgumentResult<void>;
+	auto parseShortCluster(StringRef token, ArgvReader &reader, bool execute_funcs, ParseResults &results) -> ArgumentResult<bool>;
+	auto takeUserData(const ArgumentView &arg, StringRef token, ArgvReader &reader) -> ArgumentResult<StringRef>;
+	auto runParsed(ArgIter iter, StringRef spelling, StringRef user_data, bool execute_funcs, ParseResults &results) -> ArgumentResult<void>;
+	auto runVariadic(ArgIter iter, StringRef spelling, StringRef first_value, ArgvReader &reader, bool execute_funcs, ParseResults &results) -> ArgumentResult<void>;
+	auto endsValues(StringRef token) noexcept -> bool;
+	auto applyConfig(bool execute_funcs, ParseResults &results) -> ArgumentResult<void>;
+	auto findParsed(const std::function<bool(const ArgumentView &)> &matches) const -> ArgumentResult<ParsedArgument>;
+	auto findConfig(const ArgumentView &arg, LineData &line, StringRef &value) -> bool;
+	void call(ArgIter iter, StringRef user_data, const ArgumentValue &value, ArgumentValues values, CommandStream *stream = nullptr);
+	void call(const PendingCommand &command);
+	void call(const PendingCommand &command, CommandChannel *input, CommandChannel *output);
+
+	auto group(ArgumentHandle handle) const -> ArgumentParser &;
+	void pruneGroups();
+
+	// Concurrent with snapshots retired into 'domain', which the groups
+	// share, or not concurrent for nullptr
+	void setSnapshotDomain(std::shared_ptr<SnapshotDomain> domain);
+	void markChanged() const noexcept;
+	void publish() const;
+
+	// What a RegistryLock does, for holders that outlive a scope. False and
+	// nothing to unlock for a parser that is not concurrent.
+	auto lockRegistry() const -> bool;
+	void unlockRegistry() const;
+
+	// What readers use: the latest snapshot of a concurrent parser, which
+	// needs a guard of its domain, and this parser otherwise
+	auto current() const noexcept -> ArgumentParser &;
+	auto lineTokenizer() noexcept -> CommandTokenizer &;
 
 	void addBaseArgs(std::string &&exec_name) noexcept;
+	void addHelpArg() noexcept;
 	void saveExecName(std::string name) noexcept;
 
-	void parseAndRun(std::string cmdline);
+	auto tryDispatch(const std::vector<CommandToken> &tokens) -> ArgumentResult<void>;
+	auto resolve(TokenIter iter, TokenIter end, PendingCommand &command, LineData &line) -> ArgumentResult<TokenIter>;
+	void runGroup(std::vector<PendingCommand> &group);
+	void runPipeline(const std::vector<PendingCommand> &group, std::size_t first, std::size_t last);
+	auto runLine(char *first, char *last, bool catch_except) -> bool;
+	auto runLine(CommandTokenizer &line_tokenizer, char *first, char *last, bool catch_except) -> bool;
+	void reportError(const ArgumentException &e) const;
+	auto notFound(StringRef spelling) const -> ArgumentException;
 
 	void help() const noexcept;
-	void help(std::string) const noexcept;
+	// Not noexcept: the help of a group fills the group first and what its
+	// function throws is reported like any other command error
+	void help(std::string) const;
+	void printStats(const std::string &filter) const;
+	void printHistory(StringRef text) const;
+	void addHistoryArgs();
 };
 
-template<typename Class>
-void ArgumentParser::add(std::string s_arg, std::string l_arg, std::string cmd, std::string desc, std::string ex, ArgumentFlags flags, void(Class::* func)(std::string), Class * const this_ptr) noexcept
+template<typename Class, typename Param>
+auto ArgumentParser::add(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, void (Class::*func)(Param), Class *this_ptr) noexcept -> ArgumentHandle
+{
+	return add(s_arg, l_arg, cmd, desc, ex, flags, ArgumentFunc(this_ptr, func));
+}
+
+template<typename Value, typename Func>
+auto ArgumentParser::add(StringRef s_arg, StringRef l_arg, StringRef cmd, StringRef desc, StringRef ex, ArgumentFlags flags, Func func) noexcept -> ArgumentHandle
 {
 	Argument arg;
-	arg.short_arg = s_arg;
-	arg.long_arg = l_arg;
-	arg.command = cmd;
-	arg.description = desc;
-	arg.example = ex;
-	arg.func = func;
-	arg.flags = easy_bind(func, *this_ptr);
-
-	// If one of the arguments is empty disable it (!ENABLE_*)
-	arg.flags[0] = (arg.short_arg.empty()) ? false : true;
-	arg.flags[1] = (arg.long_arg.empty()) ? false : true;
-	arg.flags[2] = (arg.command.empty()) ? false : true;
-
-	args.push_back(arg);
+	arg.short_arg = s_arg.str();
+	arg.long_arg = l_arg.str();
+	arg.command = cmd.str();
+	arg.description = desc.str();
+	arg.example = ex.str();
+	arg.flags = flags;
+	arg.value_type = ArgumentValueTraits<Value>::type;
+
+	// Only 'func' is captured, so it fits into the callback like it would alone
+	arg.value_func = [func](const ArgumentValue &value) mutable
+	{
+		func(ArgumentValueTraits<Value>::get(value));
+	};
+
+	// A typed argument without user data would never get a value
+	if(!arg.flags.isUserDataAllowed() && !arg.flags.isUserDataRequired())
+		arg.flags |= ArgumentFlags::USER_DATA_REQUIRED;
+
+	return add(std::move(arg));
 }
 
 }
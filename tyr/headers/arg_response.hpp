@@ -0,0 +1,86 @@
+#ifndef __ARG_RESPONSE__
+#define __ARG_RESPONSE__
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// A response file mapped copy-on-write, so its words can be unquoted in
+// place and only pages holding quotes or escapes are ever copied. Files
+// that cannot be mapped, like pipes, are read into a buffer instead.
+class ResponseFile
+{
+public:
+	// Throws IO_ERROR if the file cannot be read
+	explicit ResponseFile(const std::string &path);
+	~ResponseFile();
+
+	ResponseFile(const ResponseFile &) = delete;
+	auto operator =(const ResponseFile &) -> ResponseFile & = delete;
+
+	auto begin() noexcept -> char *;
+	auto end() noexcept -> char *;
+	auto path() const noexcept -> const std::string &;
+
+private:
+	std::string rf_path;
+	char *rf_map;
+	std::size_t rf_size;
+	std::vector<char> rf_buffer;
+};
+
+// The words of argv with every @path replaced by the words of that file,
+// which may name further files. Files are opened when their first word is
+// needed and split one word at a time with the quoting of the command line,
+// so a file of a million paths never becomes a million strings. The words
+// point into argv or into the files, which live as long as files() is held.
+//
+//     myapp @sources.txt --output out.bin
+class ArgvReader
+{
+public:
+	using FileList = std::vector<std::unique_ptr<ResponseFile>>;
+
+	static const std::size_t default_max_depth = 8;
+
+public:
+	// 'argv' without the program name. A 'max_depth' of 0 keeps @path as
+	// it is, otherwise files nested deeper throw SYNTAX_ERROR.
+	ArgvReader(int argc, char **argv, std::size_t max_depth = default_max_depth);
+
+	// False after the last word
+	auto next(StringRef &word) -> bool;
+	auto peek(StringRef &word) -> bool;
+
+	auto files() const noexcept -> std::shared_ptr<const FileList>;
+
+private:
+	struct Frame
+	{
+		char *iter;
+		char *last;
+	};
+
+	char **ar_argv;
+	int ar_argc;
+	int ar_pos;
+	std::size_t ar_max_depth;
+	std::vector<Frame> ar_frames;		// Files being read, the innermost last
+	std::shared_ptr<FileList> ar_files;
+	StringRef ar_peeked;
+	bool ar_has_peeked;
+
+private:
+	auto read(StringRef &word) -> bool;
+	void open(StringRef path);
+};
+
+}
+
+#endif // !__ARG_RESPONSE__
@@ -0,0 +1,270 @@
+#ifndef __ARG_RESULT__
+#define __ARG_RESULT__
+
+#include <exception>
+#include <new>
+#include <utility>
+
+#include "arg_exception.hpp"
+
+namespace CPM_TYR_CN
+{
+
+namespace details
+{
+
+// What error() of a result that is ok() refers to, made on first use
+inline auto noError() noexcept -> const ArgumentException &
+{
+	static const ArgumentException none(ArgumentException::UNKNOWN);
+	return none;
+}
+
+}
+
+// The value of a lookup or parse, or the ArgumentException it would have
+// thrown. Misses cost building the error instead of unwinding the stack,
+// so the try* functions suit callers that expect them, e.g. a loop that
+// reads unknown commands. A result that is ok() holds no error at all.
+//
+//     auto arg = parser.tryGetArgument("--output");
+//     if(!arg)
+//         std::cout << arg.error().what() << std::endl;
+//
+// value() throws the error, so a result can be used like the throwing call.
+template<typename Value>
+class ArgumentResult
+{
+public:
+	ArgumentResult(Value value) :
+		res_ok(true),
+		res_code(ArgumentException::UNKNOWN),
+		res_thrown()
+	{
+		new(&res_value) Value(std::move(value));
+	}
+
+	// 'thrown' keeps what was caught, e.g. an ArgumentGroupException, for rethrow()
+	ArgumentResult(ArgumentException error, std::exception_ptr thrown = nullptr) :
+		res_ok(false),
+		res_code(error.code()),
+		res_thrown(std::move(thrown))
+	{
+		new(&res_error) ArgumentException(std::move(error));
+	}
+
+	ArgumentResult(const ArgumentResult &orig) :
+		res_ok(orig.res_ok),
+		res_code(orig.res_code),
+		res_thrown(orig.res_thrown)
+	{
+		if(orig.ok())
+			new(&res_value) Value(orig.res_value);
+		else
+			new(&res_error) ArgumentException(orig.res_error);
+	}
+
+	ArgumentResult(ArgumentResult &&orig) :
+		res_ok(orig.res_ok),
+		res_code(orig.res_code),
+		res_thrown(std::move(orig.res_thrown))
+	{
+		if(orig.ok())
+			new(&res_value) Value(std::move(orig.res_value));
+		else
+			new(&res_error) ArgumentException(std::move(orig.res_error));
+	}
+
+	~ArgumentResult()
+	{
+		if(ok())
+			res_value.~Value();
+		else
+			res_error.~ArgumentException();
+	}
+
+	auto operator =(ArgumentResult other) -> ArgumentResult &
+	{
+		this->~ArgumentResult();
+		new(this) ArgumentResult(std::move(other));
+		return *this;
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return ok();
+	}
+
+	auto ok() const noexcept -> bool
+	{
+		return res_ok;
+	}
+
+	// Throws the error of a failed result
+	auto value() -> Value &
+	{
+		if(!ok())
+			rethrow();
+
+		return res_value;
+	}
+
+	auto value() const -> const Value &
+	{
+		if(!ok())
+			rethrow();
+
+		return res_value;
+	}
+
+	// Only for a result that is ok()
+	auto operator *() noexcept -> Value &
+	{
+		return res_value;
+	}
+
+	auto operator *() const noexcept -> const Value &
+	{
+		return res_value;
+	}
+
+	auto operator ->() noexcept -> Value *
+	{
+		return &res_value;
+	}
+
+	auto operator ->() const noexcept -> const Value *
+	{
+		return &res_value;
+	}
+
+	// UNKNOWN for a result that is ok()
+	auto code() const noexcept -> ArgumentException::ErrorCode
+	{
+		return res_code;
+	}
+
+	auto error() const noexcept -> const ArgumentException &
+	{
+		return ok() ? details::noError() : res_error;
+	}
+
+	// Throws the error, the caught exception itself if there was one
+	[[noreturn]] void rethrow() const
+	{
+		if(res_thrown)
+			std::rethrow_exception(res_thrown);
+
+		throw error();
+	}
+
+private:
+	bool res_ok;
+	ArgumentException::ErrorCode res_code;		// UNKNOWN while there is a value
+	union
+	{
+		Value res_value;
+		ArgumentException res_error;
+	};
+	std::exception_ptr res_thrown;
+};
+
+// Success or the error of a call without a value
+template<>
+class ArgumentResult<void>
+{
+public:
+	ArgumentResult() :
+		res_ok(true),
+		res_code(ArgumentException::UNKNOWN),
+		res_thrown()
+	{
+	}
+
+	ArgumentResult(ArgumentException error, std::exception_ptr thrown = nullptr) :
+		res_ok(false),
+		res_code(error.code()),
+		res_thrown(std::move(thrown))
+	{
+		new(&res_error) ArgumentException(std::move(error));
+	}
+
+	ArgumentResult(const ArgumentResult &orig) :
+		res_ok(orig.res_ok),
+		res_code(orig.res_code),
+		res_thrown(orig.res_thrown)
+	{
+		if(!orig.ok())
+			new(&res_error) ArgumentException(orig.res_error);
+	}
+
+	ArgumentResult(ArgumentResult &&orig) :
+		res_ok(orig.res_ok),
+		res_code(orig.res_code),
+		res_thrown(std::move(orig.res_thrown))
+	{
+		if(!orig.ok())
+			new(&res_error) ArgumentException(std::move(orig.res_error));
+	}
+
+	~ArgumentResult()
+	{
+		if(!ok())
+			res_error.~ArgumentException();
+	}
+
+	auto operator =(ArgumentResult other) -> ArgumentResult &
+	{
+		this->~ArgumentResult();
+		new(this) ArgumentResult(std::move(other));
+		return *this;
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return ok();
+	}
+
+	auto ok() const noexcept -> bool
+	{
+		return res_ok;
+	}
+
+	// Throws the error of a failed result
+	void value() const
+	{
+		if(!ok())
+			rethrow();
+	}
+
+	auto code() const noexcept -> ArgumentException::ErrorCode
+	{
+		return res_code;
+	}
+
+	auto error() const noexcept -> const ArgumentException &
+	{
+		return ok() ? details::noError() : res_error;
+	}
+
+	[[noreturn]] void rethrow() const
+	{
+		if(res_thrown)
+			std::rethrow_exception(res_thrown);
+
+		throw error();
+	}
+
+private:
+	bool res_ok;
+	ArgumentException::ErrorCode res_code;		// UNKNOWN while there is no error
+	union
+	{
+		ArgumentException res_error;
+	};
+	std::exception_ptr res_thrown;
+};
+
+}
+
+#endif // !__ARG_RESULT__
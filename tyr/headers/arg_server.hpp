@@ -0,0 +1,80 @@
+#ifndef __ARG_SERVER__
+#define __ARG_SERVER__
+
+#ifdef __linux__
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace CPM_TYR_CN
+{
+
+class ArgumentParser;
+
+// Serves the commands of one ArgumentParser to many local clients over a
+// Unix domain socket. Every line a client sends is run like a loop() line
+// and everything its commands write to std::cout is sent back to that
+// client, see ThreadOutput. Other threads keep writing to the terminal.
+// All clients are handled by one epoll loop on the calling thread, so
+// commands never run concurrently unless they are joined with & or |.
+//
+// The exit command only closes the connection of the client that sent it.
+//
+//     $ socat - UNIX-CONNECT:/tmp/myapp.sock
+//     open file1 && save
+class CommandServer
+{
+public:
+	// Routes std::cout by thread (see ThreadOutput), so construct it before
+	// other threads write. Throws IO_ERROR if the server cannot be created.
+	CommandServer(ArgumentParser &parser, std::string socket_path);
+	~CommandServer();
+
+	CommandServer(const CommandServer &) = delete;
+	auto operator =(const CommandServer &) -> CommandServer & = delete;
+
+	// Binds the socket and serves until stop() is called. Returns right away
+	// after a stop() that came before it, the next call serves again.
+	void run();
+
+	// May be called from any thread or a command, e.g. by a command that
+	// captured the server, before or while run() serves
+	void stop() noexcept;
+
+	auto clientCount() const noexcept -> std::size_t;
+
+private:
+	struct Client
+	{
+		std::string input;
+		std::string output;
+		bool writing;		// Waiting for EPOLLOUT
+		bool closing;
+	};
+
+	ArgumentParser &cs_parser;
+	std::string cs_path;
+	int cs_listen_fd;
+	int cs_epoll_fd;
+	int cs_wake_fd;			// Lives as long as the server, for stop()
+	std::atomic<bool> cs_stop;
+	std::unordered_map<int, Client> cs_clients;
+
+private:
+	void open();
+	void close() noexcept;
+
+	void accept();
+	void receive(int fd, Client &client);
+	void execute(Client &client, char *first, char *last);
+	void send(int fd, Client &client);
+	void drop(int fd) noexcept;
+};
+
+}
+
+#endif // __linux__
+
+#endif // !__ARG_SERVER__
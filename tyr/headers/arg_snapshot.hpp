@@ -0,0 +1,121 @@
+#ifndef __ARG_SNAPSHOT__
+#define __ARG_SNAPSHOT__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace CPM_TYR_CN
+{
+
+// Epoch based reclamation for the registry snapshots of a concurrent
+// ArgumentParser. A reader pins the current epoch in one of 'max_readers'
+// slots without locking. Writers retire a replaced snapshot with the epoch
+// it was replaced in and it is deleted once every pinned epoch is newer,
+// so nothing a reader could still see goes away under it.
+class SnapshotDomain
+{
+public:
+	static const std::size_t max_readers = 128;
+
+	// Everything loaded from a SnapshotCell of the domain stays valid while
+	// the guard is alive. Guards may be nested.
+	class Guard
+	{
+	public:
+		explicit Guard(SnapshotDomain &domain) noexcept;
+		~Guard();
+
+		Guard(const Guard &) = delete;
+		auto operator =(const Guard &) -> Guard & = delete;
+
+	private:
+		std::atomic<std::uint64_t> *gd_slot;
+	};
+
+public:
+	SnapshotDomain() noexcept;
+	~SnapshotDomain();
+
+	SnapshotDomain(const SnapshotDomain &) = delete;
+	auto operator =(const SnapshotDomain &) -> SnapshotDomain & = delete;
+
+	// 'object' has already been replaced. 'deleter' is called once no reader
+	// that could have loaded it is left, which may be right away.
+	void retire(void *object, void (*deleter)(void *));
+
+	// Deletes everything retired, including what the deleters retire.
+	// No guard may be alive.
+	void drain();
+
+	auto retiredCount() const -> std::size_t;
+
+private:
+	struct Retired
+	{
+		void *object;
+		void (*deleter)(void *);
+		std::uint64_t epoch;
+	};
+
+	std::atomic<std::uint64_t> sd_epoch;		// Starts at 1, 0 marks a free slot
+	std::atomic<std::uint64_t> sd_readers[max_readers];
+	mutable std::mutex sd_mutex;
+	std::vector<Retired> sd_retired;
+};
+
+// The current version of an immutable T. Readers load it under a guard of
+// the domain, writers replace it as a whole.
+template<typename T>
+class SnapshotCell
+{
+public:
+	explicit SnapshotCell(std::shared_ptr<SnapshotDomain> domain) noexcept :
+		sc_domain(std::move(domain)),
+		sc_current(nullptr)
+	{
+	}
+
+	~SnapshotCell()
+	{
+		publish(nullptr);
+	}
+
+	SnapshotCell(const SnapshotCell &) = delete;
+	auto operator =(const SnapshotCell &) -> SnapshotCell & = delete;
+
+	// Only while a guard of the domain is alive
+	auto load() const noexcept -> T *
+	{
+		return sc_current.load();
+	}
+
+	// Writers have to be serialized by the caller
+	void publish(std::unique_ptr<T> snapshot)
+	{
+		auto *old = sc_current.exchange(snapshot.release());
+		if(old)
+			sc_domain->retire(old, &destroy);
+	}
+
+	auto domain() const noexcept -> const std::shared_ptr<SnapshotDomain> &
+	{
+		return sc_domain;
+	}
+
+private:
+	static void destroy(void *object)
+	{
+		delete static_cast<T *>(object);
+	}
+
+	std::shared_ptr<SnapshotDomain> sc_domain;
+	std::atomic<T *> sc_current;
+};
+
+}
+
+#endif // !__ARG_SNAPSHOT__
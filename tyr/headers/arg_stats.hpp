@@ -0,0 +1,103 @@
+#ifndef __ARG_STATS__
+#define __ARG_STATS__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "arg_exception.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// Call counts, errors and latencies of the functions of every argument,
+// recorded by ArgumentParser while stats are enabled. Recording only uses
+// relaxed atomics, so the commands of a parallel group can record at once.
+// Entries are indexed by the slot of an argument's handle, which stays the
+// same when the registry compacts or is copied into a snapshot.
+class CommandStats
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// Bucket i counts calls that took less than 2^(i+1) ns, the last one
+	// also everything longer
+	static const std::size_t latency_buckets = 40;
+
+	// One slot per ArgumentException::ErrorCode, the last one for UNKNOWN
+	// and exceptions that are no ArgumentException
+	static const std::size_t error_slots = ArgumentException::INVALID_VALUE_ERROR + 2;
+
+	struct Snapshot
+	{
+		std::string name;
+		std::uint64_t calls;
+		std::uint64_t errors;
+		std::uint64_t total_ns;
+		std::uint64_t max_ns;
+		std::array<std::uint64_t, latency_buckets> latency;
+		std::array<std::uint64_t, error_slots> error_counts;
+
+		auto meanNs() const noexcept -> std::uint64_t;
+
+		// Upper bound of the bucket the given fraction of calls finished in, e.g. 0.99
+		auto percentileNs(double fraction) const noexcept -> std::uint64_t;
+
+		auto errorCount(ArgumentException::ErrorCode code) const noexcept -> std::uint64_t;
+	};
+
+public:
+	explicit CommandStats(std::size_t size = 0);
+	~CommandStats();
+
+	CommandStats(const CommandStats &) = delete;
+	auto operator =(const CommandStats &) -> CommandStats & = delete;
+
+	// Only grows. Entries never move, so other threads may record meanwhile.
+	void resize(std::size_t size);
+	void reset() noexcept;
+
+	// For a slot taken over by a new argument
+	void reset(std::size_t slot) noexcept;
+
+	void record(std::size_t slot, Clock::duration latency) noexcept;
+	void recordError(std::size_t slot, Clock::duration latency, ArgumentException::ErrorCode code) noexcept;
+
+	// 'name' is left empty, the parser knows the spellings
+	auto snapshot(std::size_t slot) const -> Snapshot;
+	auto size() const noexcept -> std::size_t;
+
+	static auto errorSlot(ArgumentException::ErrorCode code) noexcept -> std::size_t;
+
+private:
+	struct Entry
+	{
+		Entry() noexcept;
+
+		std::atomic<std::uint64_t> calls;
+		std::atomic<std::uint64_t> errors;
+		std::atomic<std::uint64_t> total_ns;
+		std::atomic<std::uint64_t> max_ns;
+		std::atomic<std::uint64_t> latency[latency_buckets];
+		std::atomic<std::uint64_t> error_counts[error_slots];
+	};
+
+	// Every chunk holds as many entries as all before it, enough for every
+	// slot of a handle. Atomics cannot be moved, chunks are never moved.
+	static const std::size_t max_chunks = 29;
+
+	std::atomic<Entry *> cst_chunks[max_chunks];
+	std::size_t cst_size;
+
+private:
+	auto entry(std::size_t slot) const noexcept -> Entry &;
+	auto count(std::size_t slot, Clock::duration latency) noexcept -> Entry &;
+	static void store(Entry &entry, const Snapshot &values) noexcept;
+};
+
+}
+
+#endif // !__ARG_STATS__
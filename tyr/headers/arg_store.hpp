@@ -0,0 +1,324 @@
+#ifndef __ARG_STORE__
+#define __ARG_STORE__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "arg.hpp"
+#include "arg_flags.hpp"
+#include "arg_string_pool.hpp"
+#include "arg_string_ref.hpp"
+#include "arg_value.hpp"
+
+namespace CPM_TYR_CN
+{
+
+class ArgumentStore;
+
+// Stable reference to a registered argument. Positions change when the
+// store compacts, handles do not. A slot is reused by later arguments with
+// a new generation, so the handle of a removed argument is detected as
+// stale instead of reaching whatever lives in its slot now.
+class ArgumentHandle
+{
+public:
+	ArgumentHandle() noexcept :
+		hd_slot(static_cast<std::uint32_t>(-1)),
+		hd_generation(0)
+	{
+	}
+
+	// Default constructed handles never refer to an argument
+	auto isNull() const noexcept -> bool
+	{
+		return hd_generation == 0;
+	}
+
+	auto operator ==(const ArgumentHandle &other) const noexcept -> bool
+	{
+		return hd_slot == other.hd_slot && hd_generation == other.hd_generation;
+	}
+
+	auto operator !=(const ArgumentHandle &other) const noexcept -> bool
+	{
+		return !(*this == other);
+	}
+
+private:
+	friend class ArgumentStore;
+
+	ArgumentHandle(std::uint32_t slot, std::uint32_t generation) noexcept :
+		hd_slot(slot),
+		hd_generation(generation)
+	{
+	}
+
+	std::uint32_t hd_slot;
+	std::uint32_t hd_generation;
+};
+
+// Read-only view of a registered argument. The texts point into the string
+// pool of the store: a view and its texts stay valid while arguments are
+// added and removed, but not after the store compacted.
+class ArgumentView
+{
+public:
+	ArgumentView(const ArgumentStore *store, std::size_t pos) noexcept;
+
+	auto shortArg() const noexcept -> StringRef;
+	auto longArg() const noexcept -> StringRef;
+	auto command() const noexcept -> StringRef;
+	auto dataInfo() const noexcept -> StringRef;
+	auto description() const noexcept -> StringRef;
+	auto longDescription() const noexcept -> StringRef;
+	auto example() const noexcept -> StringRef;
+	auto flags() const noexcept -> ArgumentFlags;
+
+	auto valueType() const noexcept -> ArgumentValue::Type;
+	auto choiceCount() const noexcept -> std::size_t;
+	auto choices() const noexcept -> const StringRef *;
+
+	auto func() const noexcept -> const ArgumentFunc &;
+	auto valueFunc() const noexcept -> const ArgumentValueFunc &;
+
+	// A single value is 0 to 1 or exactly 1, no user data 0 values
+	auto arity() const noexcept -> ArgumentArity;
+	auto valuesFunc() const noexcept -> const ArgumentValuesFunc &;
+	auto streamFunc() const noexcept -> const ArgumentStreamFunc &;
+
+	auto position() const noexcept -> std::size_t;
+	auto handle() const noexcept -> ArgumentHandle;
+
+	// Copies everything back into an Argument, e.g. to register it elsewhere
+	auto toArgument() const -> Argument;
+
+private:
+	const ArgumentStore *avw_store;
+	std::size_t avw_pos;
+};
+
+// Registry storage of an ArgumentParser. All texts are copied into one
+// string pool and the records are split by how often they are used: the
+// spellings and flags every lookup looks at are packed together, the
+// documentation only help needs lives in a separate array. Value functions
+// of typed arguments, the arity of variadic ones and stream functions are
+// kept apart since most arguments have none of them.
+//
+// Removing only marks a record as a tombstone, iteration skips them.
+// compact() drops them once needsCompaction() says they are worth it.
+class ArgumentStore
+{
+	friend class ArgumentView;
+
+public:
+	class iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = ArgumentView;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const ArgumentView *;
+		using reference = ArgumentView;
+
+		// iter->description() without a stored view
+		class Arrow
+		{
+		public:
+			explicit Arrow(ArgumentView view) noexcept :
+				ar_view(view)
+			{
+			}
+
+			auto operator ->() const noexcept -> const ArgumentView *
+			{
+				return &ar_view;
+			}
+
+		private:
+			ArgumentView ar_view;
+		};
+
+	public:
+		iterator(const ArgumentStore *store = nullptr, std::size_t pos = 0) noexcept :
+			it_store(store),
+			it_pos(pos)
+		{
+		}
+
+		auto operator *() const noexcept -> ArgumentView
+		{
+			return ArgumentView(it_store, it_pos);
+		}
+
+		auto operator ->() const noexcept -> Arrow
+		{
+			return Arrow(ArgumentView(it_store, it_pos));
+		}
+
+		auto operator ++() noexcept -> iterator &
+		{
+			it_pos = it_store->nextAlive(it_pos + 1);
+			return *this;
+		}
+
+		auto operator ++(int) noexcept -> iterator
+		{
+			iterator old = *this;
+			++*this;
+			return old;
+		}
+
+		auto operator ==(const iterator &other) const noexcept -> bool
+		{
+			return it_pos == other.it_pos && it_store == other.it_store;
+		}
+
+		auto operator !=(const iterator &other) const noexcept -> bool
+		{
+			return !(*this == other);
+		}
+
+		auto position() const noexcept -> std::size_t
+		{
+			return it_pos;
+		}
+
+	private:
+		const ArgumentStore *it_store;
+		std::size_t it_pos;
+	};
+
+public:
+	ArgumentStore() noexcept;
+	ArgumentStore(const ArgumentStore &other);
+	ArgumentStore(ArgumentStore &&other) noexcept;
+
+	auto operator =(const ArgumentStore &other) -> ArgumentStore &;
+	auto operator =(ArgumentStore &&other) noexcept -> ArgumentStore &;
+
+	static const std::size_t npos = static_cast<std::size_t>(-1);
+
+public:
+	auto add(const Argument &arg) -> ArgumentHandle;
+	auto add(Argument &&arg) -> ArgumentHandle;
+
+	// Adds a plain string argument without building an Argument first
+	auto emplace(StringRef short_arg, StringRef long_arg, StringRef command, StringRef description, StringRef example,
+		ArgumentFlags flags, ArgumentFunc &&func) -> ArgumentHandle;
+
+	void reserve(std::size_t count);
+
+	// Turns the argument into a tombstone in O(1). Its texts and functions
+	// stay until compact(). Returns false for stale handles.
+	auto erase(ArgumentHandle handle) noexcept -> bool;
+
+	// Erases every argument 'pred' returns true for and returns how many
+	auto eraseIf(const std::function<bool(const ArgumentView &)> &pred) -> std::size_t;
+
+	// Once there are at least as many tombstones as arguments
+	auto needsCompaction() const noexcept -> bool;
+
+	// Packs the arguments again, handles and slots stay valid
+	void compact();
+	void clear() noexcept;
+
+	// Position of the argument or npos if the handle is stale
+	auto find(ArgumentHandle handle) const noexcept -> std::size_t;
+	auto handle(std::size_t pos) const noexcept -> ArgumentHandle;
+	auto isAlive(std::size_t pos) const noexcept -> bool;
+
+	// Slots are numbered up to slotCount() and kept by copies and compact(),
+	// so they can index data that lives apart from the store
+	auto slot(std::size_t pos) const noexcept -> std::size_t;
+	auto slotCount() const noexcept -> std::size_t;
+
+	void setExample(std::size_t pos, StringRef example);
+	void setFlags(std::size_t pos, ArgumentFlags flags) noexcept;
+
+	auto operator [](std::size_t pos) const noexcept -> ArgumentView;
+	// Live arguments. Positions go up to recordCount(), tombstones included.
+	auto size() const noexcept -> std::size_t;
+	auto recordCount() const noexcept -> std::size_t;
+	auto capacity() const noexcept -> std::size_t;
+	auto empty() const noexcept -> bool;
+
+	auto begin() const noexcept -> iterator;
+	auto end() const noexcept -> iterator;
+
+	// Iterator of a live position
+	auto at(std::size_t pos) const noexcept -> iterator;
+
+	// Heap bytes of the records and the pool. What the callables allocate
+	// themselves is not included.
+	auto memoryUsage() const noexcept -> std::size_t;
+
+private:
+	static const std::uint32_t no_value_func = static_cast<std::uint32_t>(-1);
+	static const std::uint32_t no_slot = static_cast<std::uint32_t>(-1);
+
+	// Looked at for every token
+	struct Keys
+	{
+		StringRef short_arg;
+		StringRef long_arg;
+		StringRef command;
+		ArgumentFlags flags;
+		ArgumentValue::Type value_type;
+		std::uint32_t value_func;		// Position in 'as_value_funcs', 'as_variadics' for VARIADIC or 'as_streams' for STREAM
+		std::uint32_t slot;				// no_slot for tombstones
+	};
+
+	// Only looked at by help and aliases
+	struct Docs
+	{
+		StringRef data_info;
+		StringRef description;
+		StringRef long_description;
+		StringRef example;
+		std::uint32_t first_choice;
+		std::uint32_t choice_count;
+	};
+
+	StringPool as_pool;
+	std::vector<Keys> as_keys;
+	std::vector<Docs> as_docs;
+	std::vector<StringRef> as_choices;
+	std::vector<ArgumentFunc> as_funcs;
+	std::vector<ArgumentValueFunc> as_value_funcs;
+
+	struct Variadic
+	{
+		ArgumentArity arity;
+		ArgumentValuesFunc func;
+	};
+
+	std::vector<Variadic> as_variadics;
+	std::vector<ArgumentStreamFunc> as_streams;
+
+	// Handles refer to slots, slots to positions
+	struct Slot
+	{
+		std::uint32_t pos;
+		std::uint32_t generation;
+	};
+
+	std::vector<Slot> as_slots;
+	std::vector<std::uint32_t> as_free_slots;
+	std::size_t as_dead;
+
+private:
+	// Everything of 'arg' but its callables, which pushCallables() adds
+	void addRecord(const Argument &arg);
+	void pushCallables(const Argument &arg);
+	void pushCallables(Argument &&arg);
+	auto assignSlot() -> ArgumentHandle;
+	auto nextAlive(std::size_t pos) const noexcept -> std::size_t;
+};
+
+}
+
+#endif // !__ARG_STORE__
@@ -0,0 +1,58 @@
+#ifndef __ARG_STRING_POOL__
+#define __ARG_STRING_POOL__
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// Copies strings into large blocks. A stored string never moves, so the
+// returned views stay valid until clear() or the pool is destroyed.
+// Stored strings are null-terminated.
+class StringPool
+{
+public:
+	StringPool() noexcept;
+	StringPool(StringPool &&other) noexcept;
+	StringPool(const StringPool &) = delete;
+
+	auto operator =(StringPool &&other) noexcept -> StringPool &;
+	auto operator =(const StringPool &) -> StringPool & = delete;
+
+	// Equal strings are stored once. Only worth it for texts that repeat,
+	// every distinct string costs a slot in the lookup table.
+	auto intern(StringRef str) -> StringRef;
+
+	// Always stores a new copy
+	auto store(StringRef str) -> StringRef;
+
+	void clear() noexcept;
+
+	// Number of interned strings
+	auto size() const noexcept -> std::size_t;
+
+	// Heap bytes of the blocks and the lookup table
+	auto memoryUsage() const noexcept -> std::size_t;
+
+private:
+	static const std::size_t block_size = 16 * 1024;
+
+	std::vector<std::unique_ptr<char[]>> sp_blocks;
+	char *sp_free;						// Unused rest of the last small block
+	std::size_t sp_left;
+	std::size_t sp_block_bytes;
+	std::vector<StringRef> sp_table;	// Open addressing, power of two
+	std::size_t sp_count;
+
+private:
+	auto allocate(std::size_t size) -> char *;
+	void grow();
+};
+
+}
+
+#endif // !__ARG_STRING_POOL__
@@ -0,0 +1,127 @@
+#ifndef __ARG_STRING_REF__
+#define __ARG_STRING_REF__
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace CPM_TYR_CN
+{
+
+// Non-owning view into characters stored elsewhere (argv, an input line,
+// the argument index). Used wherever a token is only looked at.
+class StringRef
+{
+public:
+	constexpr StringRef() noexcept :
+		sr_data(nullptr),
+		sr_size(0)
+	{
+	}
+
+	constexpr StringRef(const char *data, std::size_t size) noexcept :
+		sr_data(data),
+		sr_size(size)
+	{
+	}
+
+	StringRef(const char *str) noexcept :
+		sr_data(str),
+		sr_size((str != nullptr) ? std::strlen(str) : 0)
+	{
+	}
+
+	StringRef(const std::string &str) noexcept :
+		sr_data(str.data()),
+		sr_size(str.size())
+	{
+	}
+
+	constexpr auto data() const noexcept -> const char *
+	{
+		return sr_data;
+	}
+
+	constexpr auto size() const noexcept -> std::size_t
+	{
+		return sr_size;
+	}
+
+	constexpr auto empty() const noexcept -> bool
+	{
+		return sr_size == 0;
+	}
+
+	constexpr auto begin() const noexcept -> const char *
+	{
+		return sr_data;
+	}
+
+	constexpr auto end() const noexcept -> const char *
+	{
+		return sr_data + sr_size;
+	}
+
+	constexpr auto operator[](std::size_t pos) const noexcept -> char
+	{
+		return sr_data[pos];
+	}
+
+	auto substr(std::size_t pos, std::size_t count = std::string::npos) const noexcept -> StringRef
+	{
+		if(pos > sr_size)
+			pos = sr_size;
+
+		return StringRef(sr_data + pos, (count < sr_size - pos) ? count : sr_size - pos);
+	}
+
+	auto find(char c, std::size_t pos = 0) const noexcept -> std::size_t
+	{
+		for(; pos < sr_size; pos++)
+		{
+			if(sr_data[pos] == c)
+				return pos;
+		}
+
+		return std::string::npos;
+	}
+
+	auto str() const -> std::string
+	{
+		return std::string(sr_data, sr_size);
+	}
+
+	auto operator ==(const StringRef &other) const noexcept -> bool
+	{
+		return sr_size == other.sr_size && (sr_size == 0 || std::memcmp(sr_data, other.sr_data, sr_size) == 0);
+	}
+
+	auto operator !=(const StringRef &other) const noexcept -> bool
+	{
+		return !(*this == other);
+	}
+
+private:
+	const char *sr_data;
+	std::size_t sr_size;
+};
+
+// FNV-1a, so lookups by StringRef never have to build a std::string
+struct StringRefHash
+{
+	auto operator()(const StringRef &str) const noexcept -> std::size_t
+	{
+		std::size_t hash = static_cast<std::size_t>(14695981039346656037ULL);
+		for(auto c : str)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= static_cast<std::size_t>(1099511628211ULL);
+		}
+
+		return hash;
+	}
+};
+
+}
+
+#endif // !__ARG_STRING_REF__
@@ -0,0 +1,232 @@
+#ifndef __ARG_TABLE__
+#define __ARG_TABLE__
+
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+#include "arg_exception.hpp"
+#include "arg_flags.hpp"
+
+namespace CPM_TYR_CN
+{
+
+using StaticArgumentFunc = void (*)(const char *user_data);
+
+// Literal counterpart of Argument. An array of these declared constexpr
+// lives in read-only data and needs no construction at startup.
+struct StaticArgument
+{
+	const char *short_arg;
+	const char *long_arg;
+	const char *command;
+	const char *data_info;
+	const char *description;
+	const char *example;
+	ArgumentFlags flags;
+	StaticArgumentFunc func;
+};
+
+namespace details
+{
+
+constexpr auto isEmpty(const char *str) -> bool
+{
+	return str == nullptr || *str == '\0';
+}
+
+constexpr auto sameSpelling(const char *spelling, const char *token) -> bool
+{
+	if(isEmpty(spelling) || token == nullptr)
+		return false;
+
+	while(*spelling != '\0' && *spelling == *token)
+	{
+		spelling++;
+		token++;
+	}
+
+	return *spelling == *token;
+}
+
+constexpr auto matches(const StaticArgument &arg, const char *token) -> bool
+{
+	return sameSpelling(arg.short_arg, token)
+		|| sameSpelling(arg.long_arg, token)
+		|| sameSpelling(arg.command, token);
+}
+
+template<std::size_t N>
+constexpr auto hasDuplicateSpellings(const StaticArgument (&args)[N]) -> bool
+{
+	for(std::size_t i = 0; i < N; i++)
+	{
+		for(std::size_t j = i + 1; j < N; j++)
+		{
+			if(matches(args[j], args[i].short_arg)
+				|| matches(args[j], args[i].long_arg)
+				|| matches(args[j], args[i].command))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+}
+
+template<std::size_t N>
+class ArgumentTableResult
+{
+public:
+	explicit ArgumentTableResult(const StaticArgument *args) noexcept :
+		atr_args(args),
+		atr_data()
+	{
+	}
+
+	// Returns nullptr if the argument was not passed
+	auto getUserData(std::size_t pos) const noexcept -> const char *
+	{
+		return atr_data[pos];
+	}
+
+	auto getUserData(const char *spelling) const noexcept -> const char *
+	{
+		for(std::size_t pos = 0; pos < N; pos++)
+		{
+			if(details::matches(atr_args[pos], spelling))
+				return atr_data[pos];
+		}
+
+		return nullptr;
+	}
+
+	auto isParsed(std::size_t pos) const noexcept -> bool
+	{
+		return atr_data[pos] != nullptr;
+	}
+
+	void set(std::size_t pos, const char *user_data) noexcept
+	{
+		atr_data[pos] = user_data;
+	}
+
+private:
+	const StaticArgument *atr_args;
+	const char *atr_data[N];
+};
+
+// Fixed argument table for short-lived programs. Nothing is copied or
+// allocated: the table refers to the constexpr array and parse() only
+// stores pointers into argv.
+template<std::size_t N>
+class ArgumentTable
+{
+public:
+	static const std::size_t npos = static_cast<std::size_t>(-1);
+
+public:
+	constexpr explicit ArgumentTable(const StaticArgument (&args)[N]) :
+		at_args(args)
+	{
+	}
+
+	constexpr auto size() const -> std::size_t
+	{
+		return N;
+	}
+
+	constexpr auto operator[](std::size_t pos) const -> const StaticArgument &
+	{
+		return at_args[pos];
+	}
+
+	constexpr auto find(const char *token) const -> std::size_t
+	{
+		for(std::size_t pos = 0; pos < N; pos++)
+		{
+			if(details::matches(at_args[pos], token))
+				return pos;
+		}
+
+		return npos;
+	}
+
+	auto parse(int argc, char **argv, bool execute_funcs = true) const -> ArgumentTableResult<N>
+	{
+		ArgumentTableResult<N> result(at_args);
+
+		for(int i = 1; i < argc; i++)
+		{
+			auto pos = find(argv[i]);
+			if(pos == npos)
+				continue;
+
+			const auto &arg = at_args[pos];
+			const char *user_data = "";
+
+			bool data_allowed = arg.flags.isUserDataAllowed() || arg.flags.isUserDataRequired();
+			if(data_allowed && (i + 1) < argc && find(argv[i + 1]) == npos)
+				user_data = argv[++i];
+			else if(arg.flags.isUserDataRequired())
+				throw ArgumentException(ArgumentException::NO_USER_DATA_ERROR, "The argument " + std::string(argv[i]) + " requires user data");
+
+			result.set(pos, user_data);
+
+			if(execute_funcs && arg.func != nullptr)
+				arg.func(user_data);
+		}
+
+		return result;
+	}
+
+	void help(std::ostream &out) const
+	{
+		out << "Help:\n\n";
+
+		for(std::size_t pos = 0; pos < N; pos++)
+		{
+			const auto &arg = at_args[pos];
+			const char *separator = "      ";
+
+			for(auto spelling : { arg.short_arg, arg.long_arg, arg.command })
+			{
+				if(!details::isEmpty(spelling))
+				{
+					out << separator << spelling;
+					separator = ", ";
+				}
+			}
+
+			if(!details::isEmpty(arg.data_info))
+				out << " <" << arg.data_info << ">";
+
+			if(!details::isEmpty(arg.description))
+				out << "    " << arg.description;
+
+			out << "\n";
+		}
+	}
+
+private:
+	const StaticArgument *at_args;
+};
+
+template<std::size_t N>
+const std::size_t ArgumentTable<N>::npos;
+
+// Use as 'constexpr auto table = makeArgumentTable(args);'. Throwing is not
+// a constant expression, so duplicate spellings fail to compile.
+template<std::size_t N>
+constexpr auto makeArgumentTable(const StaticArgument (&args)[N]) -> ArgumentTable<N>
+{
+	return details::hasDuplicateSpellings(args)
+		? throw std::logic_error("Two arguments share the same spelling")
+		: ArgumentTable<N>(args);
+}
+
+}
+
+#endif // !__ARG_TABLE__
@@ -0,0 +1,62 @@
+#ifndef __ARG_TOKENIZER__
+#define __ARG_TOKENIZER__
+
+#include <string>
+#include <vector>
+
+#include "arg_result.hpp"
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+class CommandToken
+{
+public:
+	enum Kind
+	{
+		WORD,
+		AND,			// &&
+		PARALLEL,		// &
+		PIPE			// |
+	};
+
+public:
+	StringRef text;
+	Kind kind;
+};
+
+// Splits a command line in a single pass. Quotes and escapes are removed
+// in place, so every token is a slice of the line itself and the token
+// buffer is reused from line to line.
+//
+//     open "my file" && save 'a b' && open my\ file
+//     load a & load b & load c && save
+//     list logs | grep error | count
+class CommandTokenizer
+{
+public:
+	auto tokenize(std::string &line) -> const std::vector<CommandToken> &;
+	auto tokenize(char *first, char *last) -> const std::vector<CommandToken> &;
+
+	// Reports a missing closing quote as a SYNTAX_ERROR instead of throwing it,
+	// the tokens are in tokens()
+	auto tryTokenize(char *first, char *last) -> ArgumentResult<void>;
+
+	auto tokens() const noexcept -> const std::vector<CommandToken> &;
+
+	// Next word of 'iter' to 'last' with the same quoting, where & and | are
+	// ordinary characters. Moves 'iter' behind it, false at the end.
+	static auto nextWord(char *&iter, char *last, StringRef &word) -> bool;
+
+private:
+	std::vector<CommandToken> ct_tokens;
+
+private:
+	// The quote that is never closed, or '\0'
+	auto split(char *first, char *last) -> char;
+};
+
+}
+
+#endif // !__ARG_TOKENIZER__
@@ -0,0 +1,80 @@
+#ifndef __ARG_TRIE__
+#define __ARG_TRIE__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+// Prefix trie over all short/long/command spellings, used for tab completion
+// and unique-prefix abbreviations. It only knows the spellings, the
+// ArgumentIndex maps them to arguments, so insert() and erase() follow
+// add() and remove() without a rebuild. A spelling may be inserted more
+// than once and stays until it was erased as often.
+class ArgumentTrie
+{
+public:
+	using Match = std::pair<std::string, std::size_t>;		// Spelling and edit distance
+
+public:
+	ArgumentTrie();
+
+	void insert(StringRef spelling);
+	void erase(StringRef spelling);
+	void clear();
+
+	auto contains(StringRef spelling) const noexcept -> bool;
+
+	// Number of distinct spellings starting with 'prefix'
+	auto count(StringRef prefix) const noexcept -> std::size_t;
+
+	// Replaces 'out' with up to 'limit' spellings starting with 'prefix' in
+	// byte order and returns how many there are in total
+	auto complete(StringRef prefix, std::vector<std::string> &out, std::size_t limit) const -> std::size_t;
+
+	// Sets 'spelling' to the only spelling starting with 'prefix'
+	auto unique(StringRef prefix, std::string &spelling) const -> bool;
+
+	// Longest prefix all spellings starting with 'prefix' share
+	auto commonPrefix(StringRef prefix) const -> std::string;
+
+	// Replaces 'out' with the spellings at most 'max_distance' edits away from
+	// 'word', closest first. Edits are insertions, deletions, substitutions
+	// and swapped neighbours. Spellings sharing a prefix share its rows of the
+	// distance table and subtrees too far away are skipped.
+	void similar(StringRef word, std::size_t max_distance, std::vector<Match> &out) const;
+
+	auto size() const noexcept -> std::size_t;
+
+private:
+	static const std::uint32_t none = static_cast<std::uint32_t>(-1);
+
+	// Children are a sorted sibling list, which keeps a node at 16 bytes
+	struct Node
+	{
+		std::uint32_t first_child;
+		std::uint32_t next_sibling;
+		std::uint32_t count;		// Distinct spellings in this subtree
+		std::uint16_t ends;			// How often the spelling ending here was inserted
+		char c;
+	};
+
+	std::vector<Node> tr_nodes;		// The root is the first node
+	std::vector<std::uint32_t> tr_free;
+
+private:
+	auto child(std::uint32_t node, char c) const noexcept -> std::uint32_t;
+	auto find(StringRef prefix) const noexcept -> std::uint32_t;
+	auto addChild(std::uint32_t node, char c) -> std::uint32_t;
+	void unlink(std::uint32_t parent, std::uint32_t node) noexcept;
+};
+
+}
+
+#endif // !__ARG_TRIE__
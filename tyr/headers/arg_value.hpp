@@ -0,0 +1,144 @@
+#ifndef __ARG_VALUE__
+#define __ARG_VALUE__
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "arg_string_ref.hpp"
+
+namespace CPM_TYR_CN
+{
+
+struct ByteSize
+{
+	unsigned long long bytes;
+};
+
+// User data converted once while parsing. The value is stored unboxed;
+// text() refers to the original user data and is only valid as long as
+// that is (argv for parse(), the current line for commands).
+class ArgumentValue
+{
+public:
+	enum Type
+	{
+		NONE,			// No user data was given
+		STRING,
+		INT,			// long long, the sized types below reject what does not fit
+		INT8,
+		INT16,
+		INT32,
+		UINT8,
+		UINT16,
+		UINT32,
+		UINT64,
+		DOUBLE,
+		BOOL,
+		ENUM,			// Index into the declared choices
+		DURATION,		// 1h30m, 250ms, 10s (a plain number means seconds)
+		BYTE_SIZE		// 512, 4k, 4KiB (1024) or 4KB (1000)
+	};
+
+public:
+	ArgumentValue() noexcept;
+
+	// The integer type holding exactly the values of an integral C++ type
+	static constexpr auto integerType(bool is_signed, std::size_t size) noexcept -> Type
+	{
+		return (size == 1) ? (is_signed ? INT8 : UINT8)
+			: (size == 2) ? (is_signed ? INT16 : UINT16)
+			: (size == 4) ? (is_signed ? INT32 : UINT32)
+			: (is_signed ? INT : UINT64);
+	}
+
+	// Non-throwing and independent of the locale. Returns false if 'text'
+	// is no valid value of 'type'; 'value' is left unchanged then.
+	static auto convert(Type type, StringRef text, const std::vector<std::string> &choices, ArgumentValue &value) noexcept -> bool;
+	static auto convert(Type type, StringRef text, const StringRef *choices, std::size_t choice_count, ArgumentValue &value) noexcept -> bool;
+
+	auto type() const noexcept -> Type;
+	auto empty() const noexcept -> bool;
+	auto text() const noexcept -> StringRef;
+
+	auto asInt() const noexcept -> long long;
+	auto asUnsigned() const noexcept -> unsigned long long;
+	auto asDouble() const noexcept -> double;
+	auto asBool() const noexcept -> bool;
+	auto asEnum() const noexcept -> std::size_t;
+	auto asDuration() const noexcept -> std::chrono::nanoseconds;
+	auto asByteSize() const noexcept -> ByteSize;
+
+private:
+	template<typename Choices>
+	static auto convertValue(Type type, StringRef text, const Choices &choices, std::size_t choice_count, ArgumentValue &value) noexcept -> bool;
+
+private:
+	Type av_type;
+	StringRef av_text;
+	union
+	{
+		long long av_int;
+		unsigned long long av_unsigned;
+		double av_double;
+		bool av_bool;
+	};
+};
+
+// Maps handler parameter types to value types for ArgumentParser::add<Value>()
+template<typename Value, typename Enable = void>
+struct ArgumentValueTraits;
+
+template<typename Value>
+struct ArgumentValueTraits<Value, typename std::enable_if<std::is_integral<Value>::value && !std::is_same<Value, bool>::value>::type>
+{
+	static const ArgumentValue::Type type = ArgumentValue::integerType(std::is_signed<Value>::value, sizeof(Value));
+	static auto get(const ArgumentValue &value) noexcept -> Value
+	{
+		return std::is_signed<Value>::value ? static_cast<Value>(value.asInt()) : static_cast<Value>(value.asUnsigned());
+	}
+};
+
+template<typename Value>
+struct ArgumentValueTraits<Value, typename std::enable_if<std::is_floating_point<Value>::value>::type>
+{
+	static const ArgumentValue::Type type = ArgumentValue::DOUBLE;
+	static auto get(const ArgumentValue &value) noexcept -> Value { return static_cast<Value>(value.asDouble()); }
+};
+
+template<>
+struct ArgumentValueTraits<bool>
+{
+	static const ArgumentValue::Type type = ArgumentValue::BOOL;
+	static auto get(const ArgumentValue &value) noexcept -> bool { return value.asBool(); }
+};
+
+template<typename Rep, typename Period>
+struct ArgumentValueTraits<std::chrono::duration<Rep, Period>>
+{
+	static const ArgumentValue::Type type = ArgumentValue::DURATION;
+	static auto get(const ArgumentValue &value) noexcept -> std::chrono::duration<Rep, Period>
+	{
+		return std::chrono::duration_cast<std::chrono::duration<Rep, Period>>(value.asDuration());
+	}
+};
+
+template<>
+struct ArgumentValueTraits<ByteSize>
+{
+	static const ArgumentValue::Type type = ArgumentValue::BYTE_SIZE;
+	static auto get(const ArgumentValue &value) noexcept -> ByteSize { return value.asByteSize(); }
+};
+
+template<>
+struct ArgumentValueTraits<StringRef>
+{
+	static const ArgumentValue::Type type = ArgumentValue::STRING;
+	static auto get(const ArgumentValue &value) noexcept -> StringRef { return value.text(); }
+};
+
+}
+
+#endif // !__ARG_VALUE__